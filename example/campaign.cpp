@@ -0,0 +1,360 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// Streams a memory-mapped recipient file through a pdu_template into a few
+// sessions, each keeping a window of outstanding submit_sm requests, and
+// reports the throughput and the distribution of response latencies.
+//
+// Usage: campaign <address> <port> <recipients> [sessions] [window]
+//
+// The recipients file is either a CSV file with MSISDNs in its first column,
+// or, if its name ends with .bin, a packed list of 8-byte big-endian MSISDNs.
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace asio = boost::asio;
+using namespace asio::experimental::awaitable_operators;
+using clock_type = std::chrono::steady_clock;
+
+constexpr auto short_message = std::string_view{ "Hello from smpp campaign" };
+
+// A read-only mapping of a whole file
+class mapped_file
+{
+    const char* data_{ nullptr };
+    std::size_t size_{};
+
+public:
+    explicit mapped_file(const char* path)
+    {
+        const auto fd = ::open(path, O_RDONLY);
+        if(fd == -1)
+            throw std::system_error{ errno, std::generic_category(), path };
+
+        struct stat st = {};
+        if(::fstat(fd, &st) == -1)
+        {
+            const auto err = errno;
+            ::close(fd);
+            throw std::system_error{ err, std::generic_category(), path };
+        }
+
+        size_ = static_cast<std::size_t>(st.st_size);
+        if(size_ != 0)
+        {
+            auto* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            const auto err = errno;
+            ::close(fd);
+            if(addr == MAP_FAILED)
+                throw std::system_error{ err, std::generic_category(), path };
+
+            // the file is read once, from the beginning to the end
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+        }
+        else
+        {
+            ::close(fd);
+        }
+    }
+
+    mapped_file(const mapped_file&) = delete;
+
+    mapped_file&
+    operator=(const mapped_file&) = delete;
+
+    ~mapped_file()
+    {
+        if(data_)
+            ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    std::string_view
+    view() const noexcept
+    {
+        return { data_, size_ };
+    }
+};
+
+// Hands out the recipients of a mapped file one at a time, so the file is
+// streamed instead of being loaded into containers
+class recipient_reader
+{
+    std::string_view data_;
+    bool packed_;
+
+public:
+    recipient_reader(std::string_view data, bool packed)
+        : data_{ data }
+        , packed_{ packed }
+    {
+    }
+
+    // The result is a view into the mapping, or into scratch for packed files
+    std::optional<std::string_view>
+    next(std::span<char, 20> scratch)
+    {
+        if(packed_)
+        {
+            if(data_.size() < 8)
+                return std::nullopt;
+
+            auto msisdn = uint64_t{};
+            for(auto i = 0; i < 8; i++)
+                msisdn = msisdn << 8 | static_cast<uint8_t>(data_[i]);
+            data_.remove_prefix(8);
+
+            const auto end =
+                std::to_chars(scratch.data(), scratch.data() + 20, msisdn).ptr;
+            return std::string_view{ scratch.data(), end };
+        }
+
+        while(!data_.empty())
+        {
+            const auto eol = std::min(data_.find('\n'), data_.size());
+            auto line      = data_.substr(0, eol);
+            data_.remove_prefix(std::min(eol + 1, data_.size()));
+
+            line = line.substr(0, line.find(','));
+            while(!line.empty() && (line.back() == '\r' || line.back() == ' '))
+                line.remove_suffix(1);
+
+            // skips empty lines and the header
+            auto digits = line.starts_with('+') ? line.substr(1) : line;
+            if(!digits.empty() &&
+               digits.find_first_not_of("0123456789") == std::string_view::npos)
+                return line;
+        }
+        return std::nullopt;
+    }
+};
+
+struct statistics
+{
+    std::size_t sent{};
+    std::size_t succeeded{};
+    std::size_t failed{};
+    std::vector<clock_type::duration> latencies;
+};
+
+asio::awaitable<void>
+run_session(
+    asio::ip::tcp::endpoint endpoint,
+    const smpp::pdu_template<smpp::submit_sm>& pdu_template,
+    recipient_reader& reader,
+    std::size_t window,
+    statistics& stats)
+{
+    auto executor = co_await asio::this_coro::executor;
+    auto session  = smpp::session{ asio::ip::tcp::socket{ executor } };
+
+    co_await session.next_layer().async_connect(endpoint);
+
+    co_await session.async_send(
+        smpp::bind_transceiver{ .system_id = "campaign" });
+    auto [pdu, seq_num, status] = co_await session.async_receive();
+    if(status != smpp::command_status::rok)
+        throw std::runtime_error{ "bind_transceiver failed" };
+
+    // send time of the outstanding requests by their sequence_number
+    auto outstanding = std::map<uint32_t, clock_type::time_point>{};
+    auto window_cv   = asio::steady_timer{
+        executor, asio::steady_timer::time_point::max()
+    };
+
+    auto send = [&]() -> asio::awaitable<void>
+    {
+        char scratch[20];
+        while(auto dest_addr = reader.next(scratch))
+        {
+            while(outstanding.size() >= window)
+                co_await window_cv.async_wait(
+                    asio::as_tuple(asio::use_awaitable));
+
+            const auto sent_at = clock_type::now();
+            const auto sequence_number = co_await session.async_send(
+                pdu_template, *dest_addr, short_message);
+            outstanding.emplace(sequence_number, sent_at);
+            stats.sent++;
+        }
+
+        while(!outstanding.empty())
+            co_await window_cv.async_wait(asio::as_tuple(asio::use_awaitable));
+
+        co_await session.async_send_unbind();
+    };
+
+    auto receive = [&]() -> asio::awaitable<void>
+    {
+        for(;;)
+        {
+            auto [ec, pdu, seq_num, status] = co_await session.async_receive(
+                asio::as_tuple(asio::use_awaitable));
+
+            if(ec == smpp::error::unbinded)
+                co_return;
+            if(ec)
+                throw boost::system::system_error{ ec };
+
+            if(std::holds_alternative<smpp::deliver_sm>(pdu))
+            {
+                co_await session.async_send(
+                    smpp::deliver_sm_resp{},
+                    seq_num,
+                    smpp::command_status::rok);
+                continue;
+            }
+
+            auto it = outstanding.find(seq_num);
+            if(it == outstanding.end())
+                continue;
+
+            stats.latencies.push_back(clock_type::now() - it->second);
+            if(status == smpp::command_status::rok)
+                stats.succeeded++;
+            else
+                stats.failed++;
+
+            outstanding.erase(it);
+            window_cv.cancel();
+        }
+    };
+
+    co_await (send() && receive());
+}
+
+asio::awaitable<void>
+report_progress(const statistics& stats, const std::size_t& running)
+{
+    auto timer = asio::steady_timer{ co_await asio::this_coro::executor };
+    auto last  = std::size_t{};
+    while(running != 0)
+    {
+        timer.expires_after(std::chrono::seconds{ 1 });
+        co_await timer.async_wait(asio::use_awaitable);
+
+        const auto responses = stats.succeeded + stats.failed;
+        std::cout << "sent: " << stats.sent << ", responses: " << responses
+                  << ", rate: " << responses - last << "/s\n";
+        last = responses;
+    }
+}
+
+void
+print_report(statistics& stats, clock_type::duration elapsed)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    const auto seconds   = std::chrono::duration<double>{ elapsed }.count();
+    const auto responses = stats.succeeded + stats.failed;
+
+    std::cout << "\nsent:       " << stats.sent << '\n'
+              << "succeeded:  " << stats.succeeded << '\n'
+              << "failed:     " << stats.failed << '\n'
+              << "elapsed:    " << seconds << "s\n"
+              << "throughput: " << responses / seconds << "/s\n";
+
+    if(stats.latencies.empty())
+        return;
+
+    std::sort(stats.latencies.begin(), stats.latencies.end());
+    std::cout << "latency:\n";
+    for(auto percentile : { 50.0, 90.0, 99.0, 99.9, 100.0 })
+    {
+        const auto size  = stats.latencies.size();
+        const auto index = std::min(
+            size - 1,
+            static_cast<std::size_t>(
+                percentile / 100 * static_cast<double>(size)));
+        std::cout << "  p" << percentile << ": "
+                  << duration_cast<microseconds>(stats.latencies[index]).count()
+                  << "us\n";
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    if(argc < 4)
+    {
+        std::cerr << "Usage: campaign <address> <port> <recipients> "
+                     "[sessions] [window]\n";
+        return 1;
+    }
+
+    try
+    {
+        const auto endpoint = asio::ip::tcp::endpoint{
+            asio::ip::make_address(argv[1]),
+            static_cast<asio::ip::port_type>(std::stoul(argv[2]))
+        };
+        const auto sessions = argc > 4 ? std::stoul(argv[4]) : 4;
+        const auto window   = argc > 5 ? std::stoul(argv[5]) : 64;
+
+        const auto file = mapped_file{ argv[3] };
+        auto reader     = recipient_reader{
+            file.view(), std::string_view{ argv[3] }.ends_with(".bin")
+        };
+
+        // everything but dest_addr and short_message is serialized once
+        const auto pdu_template =
+            smpp::pdu_template{ smpp::submit_sm{ .source_addr = "CAMPAIGN" } };
+
+        auto ctx     = asio::io_context{ 1 };
+        auto stats   = statistics{};
+        auto running = std::size_t{ sessions };
+
+        for(auto i = std::size_t{}; i < sessions; i++)
+            asio::co_spawn(
+                ctx,
+                run_session(endpoint, pdu_template, reader, window, stats),
+                [&](auto eptr)
+                {
+                    running--;
+                    try
+                    {
+                        if(eptr)
+                            std::rethrow_exception(eptr);
+                    }
+                    catch(const std::exception& e)
+                    {
+                        std::cerr << "Exception in session: " << e.what()
+                                  << '\n';
+                    }
+                });
+
+        asio::co_spawn(ctx, report_progress(stats, running), asio::detached);
+
+        const auto start = clock_type::now();
+        ctx.run();
+        print_report(stats, clock_type::now() - start);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Exception: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -35,51 +35,37 @@ handle_session(smpp::session session)
     }
 }
 
-asio::awaitable<void>
-acceptor()
-{
-    auto executor = co_await asio::this_coro::executor;
-    auto endpoint = asio::ip::tcp::endpoint{ asio::ip::tcp::v4(), 2775 };
-    auto acceptor = asio::ip::tcp::acceptor(executor, endpoint);
-
-    for(;;)
-    {
-        auto socket = co_await acceptor.async_accept();
-        asio::co_spawn(
-            executor,
-            handle_session(std::move(socket)),
-            [](auto eptr)
-            {
-                try
-                {
-                    if(eptr)
-                        std::rethrow_exception(eptr);
-                }
-                catch(const std::exception& e)
-                {
-                    std::cerr << "Exception in session: " << e.what() << '\n';
-                }
-            });
-    }
-}
-
 int
 main(int, const char**)
 {
     try
     {
-        auto ctx = asio::io_context{};
+        // one io_context per core, each with its own SO_REUSEPORT acceptor
+        auto server = smpp::thread_per_core_server{
+            { asio::ip::tcp::v4(), 2775 }
+        };
 
-        asio::co_spawn(
-            ctx,
-            acceptor(),
-            [](auto eptr)
+        server.run(
+            [](asio::ip::tcp::socket socket, std::size_t)
             {
-                if(eptr)
-                    std::rethrow_exception(eptr);
+                auto executor = socket.get_executor();
+                asio::co_spawn(
+                    executor,
+                    handle_session(std::move(socket)),
+                    [](auto eptr)
+                    {
+                        try
+                        {
+                            if(eptr)
+                                std::rethrow_exception(eptr);
+                        }
+                        catch(const std::exception& e)
+                        {
+                            std::cerr << "Exception in session: " << e.what()
+                                      << '\n';
+                        }
+                    });
             });
-
-        ctx.run();
     }
     catch(const std::exception& e)
     {
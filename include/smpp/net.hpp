@@ -4,7 +4,19 @@
 
 #pragma once
 
+#include <smpp/net/delivery_tracker.hpp>
+#include <smpp/net/endpoint_router.hpp>
+#include <smpp/net/endpoint_selector.hpp>
 #include <smpp/net/error.hpp>
 #include <smpp/net/invalid_pdu.hpp>
+#include <smpp/net/managed_session.hpp>
+#include <smpp/net/pdu_template.hpp>
 #include <smpp/net/pdu_variant.hpp>
+#include <smpp/net/prefix_router.hpp>
+#include <smpp/net/relay.hpp>
+#include <smpp/net/retry_policy.hpp>
+#include <smpp/net/retry_scheduler.hpp>
 #include <smpp/net/session.hpp>
+#include <smpp/net/session_pool.hpp>
+#include <smpp/net/shared_frame.hpp>
+#include <smpp/net/thread_per_core_server.hpp>
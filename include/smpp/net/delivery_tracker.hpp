@@ -0,0 +1,512 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/net/detail/delivery_table.hpp>
+#include <smpp/net/error.hpp>
+#include <smpp/pdu/data_sm.hpp>
+#include <smpp/pdu/deliver_sm.hpp>
+#include <smpp/utility/delivery_receipt.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <concepts>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace smpp
+{
+namespace asio = boost::asio;
+
+/// Correlates delivery receipts with submitted messages
+/**
+ * A delivery_tracker maps the message_id of each submitted message, as
+ * returned in its submit_sm_resp, to a 64-bit context of the application until
+ * the delivery receipt arrives or the entry expires. Entries live in an open
+ * addressing hash table of 24 octets per slot, message IDs are kept as 64-bit
+ * hashes, and the table can be placed in a memory mapped file to survive
+ * restarts. Expired entries are swept incrementally as new ones are tracked.
+ *
+ * Receipts are fed by the sessions that the tracker is attached to, see
+ * session::set_delivery_tracker, or by calling on_delivery_receipt. An SMSC
+ * can send a receipt right after the submit_sm_resp, before the application
+ * has tracked the message, so the receipts of untracked messages are kept for
+ * a few seconds and replayed when their message is tracked. A
+ * delivery_tracker is not thread-safe, it should be used on the executor of
+ * its sessions.
+ */
+class delivery_tracker
+{
+public:
+    using clock = std::chrono::system_clock;
+
+    using delivery_handler =
+        std::function<void(uint64_t, const delivery_receipt&)>;
+
+private:
+    struct waiter
+    {
+        asio::steady_timer cv;
+        boost::system::error_code ec{};
+        message_state state{ message_state::unknown };
+        bool done{ false };
+    };
+
+    // An owning copy of a receipt that has arrived before its message was
+    // tracked, storage holds its id, error and text one after another
+    struct early_receipt
+    {
+        uint64_t key;
+        clock::time_point received;
+        delivery_receipt receipt; // without the views
+        std::string storage;
+        std::size_t id_size;
+        std::size_t error_size;
+        bool replay{ false };
+    };
+
+    static constexpr std::size_t max_early_receipts{ 256 };
+    static constexpr std::chrono::seconds early_receipt_ttl{ 10 };
+
+    asio::any_io_executor executor_;
+    detail::delivery_table table_;
+    std::unordered_multimap<uint64_t, waiter*> waiters_;
+    delivery_handler delivery_handler_;
+    std::deque<early_receipt> early_receipts_;
+    asio::steady_timer replay_timer_{ executor_ };
+    bool replay_scheduled_{ false };
+
+public:
+    /// Construct a delivery_tracker in memory
+    /**
+     * @param executor The executor of async_wait_delivery operations
+     * @param max_size The maximum number of tracked messages
+     */
+    delivery_tracker(asio::any_io_executor executor, std::size_t max_size)
+        : executor_{ std::move(executor) }
+        , table_{ max_size }
+    {
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    /// Construct a delivery_tracker in a memory mapped file
+    /**
+     * The entries of an existing file with the same max_size are kept, a file
+     * with another layout, or with more entries than max_size, is cleared.
+     *
+     * @throw std::system_error if the file can not be opened or mapped.
+     *
+     * @param executor The executor of async_wait_delivery operations
+     * @param max_size The maximum number of tracked messages
+     * @param path The path of the file
+     */
+    delivery_tracker(
+        asio::any_io_executor executor,
+        std::size_t max_size,
+        const std::string& path)
+        : executor_{ std::move(executor) }
+        , table_{ max_size, path }
+    {
+    }
+#endif
+
+    delivery_tracker(const delivery_tracker&) = delete;
+
+    delivery_tracker&
+    operator=(const delivery_tracker&) = delete;
+
+    ~delivery_tracker()
+    {
+        fail_waiters(asio::error::operation_aborted);
+    }
+
+    /// Set the handler of the receipts of tracked messages
+    /**
+     * The handler is invoked with the context of the message and its receipt,
+     * whose fields are views into the PDU and only valid during the call.
+     */
+    void
+    set_delivery_handler(delivery_handler handler)
+    {
+        delivery_handler_ = std::move(handler);
+    }
+
+    /// Return the number of tracked messages
+    std::size_t
+    size() const noexcept
+    {
+        return table_.size();
+    }
+
+    /// Track a message
+    /**
+     * Tracking a message_id that is already tracked replaces its context and
+     * its expiry.
+     *
+     * @throw std::length_error if max_size messages are tracked.
+     *
+     * @param message_id The message_id from submit_sm_resp
+     * @param context The context of the application
+     * @param ttl The time to keep the entry, like the validity period
+     * @param now The current time
+     */
+    void
+    track(
+        std::string_view message_id,
+        uint64_t context,
+        std::chrono::seconds ttl,
+        clock::time_point now = clock::now())
+    {
+        const auto now_s = to_seconds(now);
+        // amortizes expiry over insertions
+        sweep(now_s, 4);
+
+        const auto key = detail::delivery_table::hash(message_id);
+        if(!table_.insert(
+               key, context, now_s + static_cast<uint32_t>(ttl.count())))
+            throw std::length_error{ "delivery_tracker is full" };
+
+        schedule_replay(key, now);
+    }
+
+    /// Return the context of a tracked message
+    std::optional<uint64_t>
+    find(std::string_view message_id, clock::time_point now = clock::now())
+    {
+        const auto key   = detail::delivery_table::hash(message_id);
+        const auto* slot = table_.find(key);
+        if(!slot || slot->expires <= to_seconds(now))
+            return std::nullopt;
+        return slot->context;
+    }
+
+    /// Stop tracking a message
+    /**
+     * async_wait_delivery operations of the message complete with
+     * smpp::error::delivery_not_tracked.
+     *
+     * @return A boolean indicating if the message was tracked.
+     */
+    bool
+    untrack(std::string_view message_id)
+    {
+        const auto key = detail::delivery_table::hash(message_id);
+        auto* slot     = table_.find(key);
+        if(!slot)
+            return false;
+        table_.erase(slot);
+        complete_waiters(key, error::delivery_not_tracked, {});
+        return true;
+    }
+
+    /// Evict the expired messages
+    /**
+     * Their async_wait_delivery operations complete with
+     * smpp::error::delivery_expired.
+     */
+    void
+    expire(clock::time_point now = clock::now())
+    {
+        sweep(to_seconds(now), table_.slots());
+    }
+
+    /// Handle a PDU that might be a delivery receipt
+    /**
+     * The PDU is ignored unless it is a deliver_sm or data_sm with a
+     * message_type of delivery_receipt whose message is tracked, in which case
+     * the message is untracked and the delivery handler and async_wait_delivery
+     * operations of the message are completed. Receipts with an intermediate
+     * state, like enroute or accepted, leave the message tracked. The
+     * receipt of an untracked message is kept and replayed if the message is
+     * tracked within a few seconds.
+     *
+     * @return A boolean indicating if the receipt was of a tracked message.
+     */
+    template<typename Pdu>
+        requires std::same_as<Pdu, deliver_sm> || std::same_as<Pdu, data_sm>
+    bool
+    on_delivery_receipt(const Pdu& pdu, clock::time_point now = clock::now())
+    {
+        if(pdu.esm_class.message_type != message_type::delivery_receipt)
+            return false;
+
+        const auto receipt = parse_delivery_receipt(pdu);
+        if(!receipt)
+            return false;
+
+        const auto key = detail::delivery_table::hash(receipt->id);
+        if(deliver(key, *receipt))
+            return true;
+
+        keep_early_receipt(key, *receipt, now);
+        return false;
+    }
+
+    /// Start an asynchronous wait for the delivery receipt of a message
+    /**
+     * This function is used to asynchronously wait for the delivery receipt
+     * of a tracked message. It is an initiating function for an
+     * asynchronous_operation, and always returns immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, message_state) @endcode
+     * Completes with the state of the first receipt of the message. If the
+     * message is not tracked, or is untracked, completes with
+     * smpp::error::delivery_not_tracked. If the message expires, completes
+     * with smpp::error::delivery_expired.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     * @li cancellation_type::partial
+     * @li cancellation_type::total
+     *
+     * @param message_id The message_id from submit_sm_resp
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the receipt arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, message_state)> CompletionToken =
+            asio::deferred_t>
+    auto
+    async_wait_delivery(
+        std::string_view message_id,
+        CompletionToken&& token = asio::deferred_t{})
+    {
+        return asio::async_compose<
+            CompletionToken,
+            void(boost::system::error_code, message_state)>(
+            [this,
+             key = detail::delivery_table::hash(message_id),
+             w   = std::unique_ptr<waiter>{},
+             c   = asio::coroutine{}](
+                auto&& self, boost::system::error_code ec = {}) mutable
+            {
+                BOOST_ASIO_CORO_REENTER(c)
+                {
+                    self.reset_cancellation_state(
+                        asio::enable_total_cancellation());
+
+                    if(!table_.find(key))
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        asio::post(std::move(self));
+                        return self.complete(
+                            error::delivery_not_tracked, message_state{});
+                    }
+
+                    w = std::make_unique<waiter>(waiter{ asio::steady_timer{
+                        executor_, asio::steady_timer::time_point::max() } });
+                    waiters_.emplace(key, w.get());
+
+                    while(!w->done)
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        w->cv.async_wait(std::move(self));
+                        if(!w->done &&
+                           (ec != asio::error::operation_aborted ||
+                            !!self.cancelled()))
+                        {
+                            erase_waiter(key, w.get());
+                            return self.complete(
+                                ec ? ec : asio::error::operation_aborted,
+                                message_state{});
+                        }
+                    }
+
+                    self.complete(w->ec, w->state);
+                }
+            },
+            token,
+            executor_);
+    }
+
+private:
+    bool
+    deliver(uint64_t key, const delivery_receipt& receipt)
+    {
+        auto* slot = table_.find(key);
+        if(!slot)
+            return false;
+
+        const auto context = slot->context;
+        const auto state   = receipt.state.value_or(message_state::unknown);
+        if(state != message_state::enroute && state != message_state::accepted)
+            table_.erase(slot);
+
+        if(delivery_handler_)
+            delivery_handler_(context, receipt);
+
+        complete_waiters(key, {}, state);
+        return true;
+    }
+
+    void
+    drop_early_receipts(clock::time_point now)
+    {
+        while(!early_receipts_.empty() &&
+              (early_receipts_.size() > max_early_receipts ||
+               early_receipts_.front().received + early_receipt_ttl <= now))
+            early_receipts_.pop_front();
+    }
+
+    void
+    keep_early_receipt(
+        uint64_t key,
+        const delivery_receipt& receipt,
+        clock::time_point now)
+    {
+        auto e = early_receipt{ .key        = key,
+                                .received   = now,
+                                .receipt    = receipt,
+                                .storage    = std::string{ receipt.id },
+                                .id_size    = receipt.id.size(),
+                                .error_size = receipt.error.size() };
+        e.storage += receipt.error;
+        e.storage += receipt.text;
+        e.receipt.id    = {};
+        e.receipt.error = {};
+        e.receipt.text  = {};
+        early_receipts_.push_back(std::move(e));
+        drop_early_receipts(now);
+    }
+
+    void
+    schedule_replay(uint64_t key, clock::time_point now)
+    {
+        if(early_receipts_.empty())
+            return;
+
+        drop_early_receipts(now);
+        auto found = false;
+        for(auto& e : early_receipts_)
+            if(e.key == key)
+                found = e.replay = true;
+
+        // posted, so the caller of track can start async_wait_delivery first
+        if(!found || replay_scheduled_)
+            return;
+
+        replay_scheduled_ = true;
+        replay_timer_.expires_at(asio::steady_timer::time_point::min());
+        replay_timer_.async_wait(
+            [this](boost::system::error_code ec)
+            {
+                // the tracker might be destroyed
+                if(ec == asio::error::operation_aborted)
+                    return;
+                replay_scheduled_ = false;
+                replay();
+            });
+    }
+
+    void
+    replay()
+    {
+        // the handler might track messages, which modifies early_receipts_
+        auto replays = std::vector<early_receipt>{};
+        for(auto it = early_receipts_.begin(); it != early_receipts_.end();)
+        {
+            if(it->replay)
+            {
+                replays.push_back(std::move(*it));
+                it = early_receipts_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for(auto& e : replays)
+        {
+            const auto storage = std::string_view{ e.storage };
+            auto receipt       = e.receipt;
+            receipt.id         = storage.substr(0, e.id_size);
+            receipt.error      = storage.substr(e.id_size, e.error_size);
+            receipt.text       = storage.substr(e.id_size + e.error_size);
+            deliver(e.key, receipt);
+        }
+    }
+
+    static uint32_t
+    to_seconds(clock::time_point time) noexcept
+    {
+        return static_cast<uint32_t>(
+            std::chrono::floor<std::chrono::seconds>(time.time_since_epoch())
+                .count());
+    }
+
+    void
+    sweep(uint32_t now, std::size_t count)
+    {
+        table_.sweep(
+            now,
+            count,
+            [&](const detail::delivery_slot& slot)
+            {
+                if(!waiters_.empty())
+                    complete_waiters(slot.key, error::delivery_expired, {});
+            });
+    }
+
+    void
+    complete_waiters(
+        uint64_t key,
+        boost::system::error_code ec,
+        message_state state)
+    {
+        const auto [begin, end] = waiters_.equal_range(key);
+        for(auto it = begin; it != end; ++it)
+        {
+            it->second->ec    = ec;
+            it->second->state = state;
+            it->second->done  = true;
+            it->second->cv.cancel();
+        }
+        waiters_.erase(begin, end);
+    }
+
+    void
+    erase_waiter(uint64_t key, waiter* w)
+    {
+        const auto [begin, end] = waiters_.equal_range(key);
+        for(auto it = begin; it != end; ++it)
+        {
+            if(it->second == w)
+            {
+                waiters_.erase(it);
+                return;
+            }
+        }
+    }
+
+    void
+    fail_waiters(boost::system::error_code ec)
+    {
+        for(auto& [key, w] : waiters_)
+        {
+            w->ec   = ec;
+            w->done = true;
+            w->cv.cancel();
+        }
+        waiters_.clear();
+    }
+};
+} // namespace smpp
@@ -0,0 +1,259 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <bit>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace smpp::detail
+{
+// 24 octets per tracked message, message IDs are kept as 64-bit hashes
+struct delivery_slot
+{
+    uint64_t key;
+    uint64_t context;
+    uint32_t expires; // seconds since the Unix epoch
+    uint32_t reserved;
+};
+
+// An open addressing hash table with linear probing and backward shift
+// deletion, that can live in a memory mapped file
+class delivery_table
+{
+    struct file_header
+    {
+        uint64_t magic;
+        uint64_t capacity;
+    };
+
+    static constexpr uint64_t magic{ 0x534d50504452'0001 }; // "SMPPDR" v1
+
+    std::unique_ptr<delivery_slot[]> owned_;
+    void* mapping_{ nullptr };
+    std::size_t mapping_size_{};
+    delivery_slot* slots_{ nullptr };
+    std::size_t mask_{};
+    std::size_t size_{};
+    std::size_t max_size_{};
+    std::size_t cursor_{};
+
+public:
+    static uint64_t
+    hash(std::string_view message_id) noexcept
+    {
+        // FNV-1a followed by a finalizer, zero marks an empty slot
+        auto h = uint64_t{ 0xcbf29ce484222325 };
+        for(auto c : message_id)
+            h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccd;
+        h ^= h >> 33;
+        return h == 0 ? 1 : h;
+    }
+
+    explicit delivery_table(std::size_t max_size)
+        : mask_{ slot_count(max_size) - 1 }
+        , max_size_{ max_size }
+    {
+        owned_ = std::make_unique<delivery_slot[]>(mask_ + 1);
+        slots_ = owned_.get();
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    delivery_table(std::size_t max_size, const std::string& path)
+        : mask_{ slot_count(max_size) - 1 }
+        , max_size_{ max_size }
+    {
+        const auto fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if(fd == -1)
+            throw std::system_error{ errno, std::generic_category() };
+
+        mapping_size_ =
+            sizeof(file_header) + (mask_ + 1) * sizeof(delivery_slot);
+
+        struct stat st = {};
+        ::fstat(fd, &st);
+        const auto existing = static_cast<std::size_t>(st.st_size);
+
+        if(existing != mapping_size_ &&
+           ::ftruncate(fd, static_cast<off_t>(mapping_size_)) == -1)
+        {
+            const auto err = errno;
+            ::close(fd);
+            throw std::system_error{ err, std::generic_category() };
+        }
+
+        mapping_ = ::mmap(
+            nullptr,
+            mapping_size_,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            fd,
+            0);
+        const auto err = errno;
+        ::close(fd);
+        if(mapping_ == MAP_FAILED)
+            throw std::system_error{ err, std::generic_category() };
+
+        auto* header = static_cast<file_header*>(mapping_);
+        slots_       = reinterpret_cast<delivery_slot*>(header + 1);
+
+        const auto same_layout = existing == mapping_size_ &&
+            header->magic == magic && header->capacity == mask_ + 1;
+
+        if(same_layout)
+        {
+            for(auto i = std::size_t{}; i <= mask_; i++)
+                size_ += slots_[i].key != 0;
+        }
+
+        // a new file, one of another layout, or one with more entries than a
+        // smaller max_size that rounds to the same capacity allows
+        if(!same_layout || size_ > max_size_)
+        {
+            size_ = 0;
+            std::memset(mapping_, 0, mapping_size_);
+            header->magic    = magic;
+            header->capacity = mask_ + 1;
+        }
+    }
+#endif
+
+    delivery_table(const delivery_table&) = delete;
+
+    delivery_table&
+    operator=(const delivery_table&) = delete;
+
+    ~delivery_table()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if(mapping_)
+            ::munmap(mapping_, mapping_size_);
+#endif
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_size_;
+    }
+
+    // Returns nullptr if the key is absent
+    delivery_slot*
+    find(uint64_t key) noexcept
+    {
+        for(auto i = home(key);; i = (i + 1) & mask_)
+        {
+            if(slots_[i].key == key)
+                return &slots_[i];
+            if(slots_[i].key == 0)
+                return nullptr;
+        }
+    }
+
+    // Inserts or replaces, returns false if the table is full
+    bool
+    insert(uint64_t key, uint64_t context, uint32_t expires) noexcept
+    {
+        auto i = home(key);
+        for(; slots_[i].key != 0; i = (i + 1) & mask_)
+        {
+            if(slots_[i].key == key)
+            {
+                slots_[i].context = context;
+                slots_[i].expires = expires;
+                return true;
+            }
+        }
+
+        if(size_ >= max_size_)
+            return false;
+
+        slots_[i] = { key, context, expires, 0 };
+        size_++;
+        return true;
+    }
+
+    void
+    erase(delivery_slot* slot) noexcept
+    {
+        auto i = static_cast<std::size_t>(slot - slots_);
+        for(auto j = (i + 1) & mask_; slots_[j].key != 0; j = (j + 1) & mask_)
+        {
+            // an entry stays if its home is cyclically in (i, j]
+            const auto k = home(slots_[j].key);
+            if(i <= j ? (i < k && k <= j) : (i < k || k <= j))
+                continue;
+
+            slots_[i] = slots_[j];
+            i         = j;
+        }
+        slots_[i] = {};
+        size_--;
+    }
+
+    // Visits count slots from where the last sweep has stopped and erases
+    // the entries that have expired, after passing them to on_expired
+    template<typename Function>
+    void
+    sweep(uint32_t now, std::size_t count, Function&& on_expired)
+    {
+        while(count != 0 && size_ != 0)
+        {
+            auto& slot = slots_[cursor_];
+            if(slot.key != 0 && slot.expires <= now)
+            {
+                on_expired(slot);
+                // erase might shift another entry into this slot
+                erase(&slot);
+                continue;
+            }
+            cursor_ = (cursor_ + 1) & mask_;
+            count--;
+        }
+    }
+
+    std::size_t
+    slots() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+private:
+    static std::size_t
+    slot_count(std::size_t max_size)
+    {
+        if(max_size == 0)
+            throw std::invalid_argument{ "delivery_table max_size is zero" };
+        // keeps the load factor under 7/8
+        return std::bit_ceil(max_size + max_size / 7 + 1);
+    }
+
+    std::size_t
+    home(uint64_t key) const noexcept
+    {
+        return static_cast<std::size_t>(key) & mask_;
+    }
+};
+} // namespace smpp::detail
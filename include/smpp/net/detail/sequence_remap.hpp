@@ -0,0 +1,99 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cinttypes>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace smpp::detail
+{
+// Maps the sequence_numbers that a session assigns to a value. Because they
+// are assigned in order, a sequence_number indexes a power-of-two ring
+// directly, a slot is only taken by a request that is a ring span older. The
+// ring is doubled for it if the ring is at least half full, up to
+// max_capacity, otherwise the older request is taken as dropped, like one
+// that the peer never answers, and is forgotten so the ring stays compact.
+template<typename T>
+class sequence_remap
+{
+    struct slot
+    {
+        uint32_t key; // zero marks an empty slot, sequence_numbers start at 1
+        T value;
+    };
+
+    static constexpr std::size_t max_capacity{ 1 << 20 };
+
+    std::vector<slot> slots_;
+    std::size_t size_{};
+
+public:
+    explicit sequence_remap(std::size_t capacity = 256)
+        : slots_(capacity)
+    {
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t
+    capacity() const noexcept
+    {
+        return slots_.size();
+    }
+
+    void
+    insert(uint32_t key, T value)
+    {
+        while(needs_growth(key) && slots_.size() < max_capacity)
+            grow();
+
+        auto& s = slots_[key & mask()];
+        if(s.key == 0)
+            size_++;
+        s = { key, value };
+    }
+
+    std::optional<T>
+    extract(uint32_t key) noexcept
+    {
+        auto& s = slots_[key & mask()];
+        if(s.key != key || key == 0)
+            return std::nullopt;
+        s.key = 0;
+        size_--;
+        return s.value;
+    }
+
+private:
+    bool
+    needs_growth(uint32_t key) const noexcept
+    {
+        const auto& s = slots_[key & mask()];
+        return s.key != 0 && s.key != key && size_ >= slots_.size() / 2;
+    }
+
+    std::size_t
+    mask() const noexcept
+    {
+        return slots_.size() - 1;
+    }
+
+    void
+    grow()
+    {
+        // keys in distinct slots stay in distinct slots of a doubled ring
+        auto old = std::exchange(slots_, std::vector<slot>(slots_.size() * 2));
+        for(const auto& s : old)
+            if(s.key != 0)
+                slots_[s.key & mask()] = s;
+    }
+};
+} // namespace smpp::detail
@@ -0,0 +1,263 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/net/endpoint_selector.hpp>
+#include <smpp/net/error.hpp>
+#include <smpp/net/pdu_variant.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/post.hpp>
+
+#include <chrono>
+#include <concepts>
+#include <stdexcept>
+#include <vector>
+
+namespace smpp
+{
+namespace asio = boost::asio;
+
+/// Routes requests over multiple endpoints
+/**
+ * Endpoint can be smpp::session or smpp::session_pool, or any type that
+ * provides get_executor and an async_request operation with a response
+ * timeout and the same completion signature. The timeout is left to the
+ * endpoint, which applies it to the response wait only, so a timeout never
+ * aborts a write in the middle of a frame and corrupts a bind that is
+ * otherwise healthy.
+ *
+ * If Endpoint provides enquire_link_rtt, like smpp::session, the RTT of the
+ * last enquire_link of each endpoint is fed to the endpoint_selector when it
+ * changes, so idle endpoints keep their RTT up to date. Otherwise only the
+ * RTT of routed requests is recorded.
+ */
+template<typename Endpoint>
+class endpoint_router
+{
+    using clock = endpoint_selector::clock;
+
+    std::vector<Endpoint*> endpoints_;
+    asio::any_io_executor executor_;
+    endpoint_selector selector_;
+    std::chrono::milliseconds response_timeout_;
+    std::vector<clock::duration> enquire_link_rtts_;
+
+public:
+    /// Construct an endpoint_router
+    /**
+     * The executor of the first endpoint is used for completions that are
+     * not the result of an endpoint operation.
+     *
+     * @throw std::invalid_argument if endpoints is empty.
+     *
+     * @param endpoints The endpoints that requests would be routed to, they
+     * should outlive the endpoint_router
+     * @param response_timeout The time to wait for a response before counting
+     * it as a failure of the endpoint
+     * @param options The options of the circuit breakers
+     */
+    explicit endpoint_router(
+        std::vector<Endpoint*> endpoints,
+        std::chrono::milliseconds response_timeout = std::chrono::seconds{ 10 },
+        circuit_breaker_options options            = {});
+
+    /// Return a reference to the endpoint_selector
+    /**
+     * It can be used for inspecting the state of the endpoints or feeding
+     * extra RTT samples, like the enquire_link RTT of the sessions of a
+     * session_pool.
+     */
+    endpoint_selector&
+    selector() noexcept;
+
+    /// Return a const reference to the endpoint_selector
+    const endpoint_selector&
+    selector() const noexcept;
+
+    /// Start an asynchronous request on the best healthy endpoint
+    /**
+     * This function is used to asynchronously send a request PDU over the
+     * endpoint selected by endpoint_selector and wait for its response. It is
+     * an initiating function for an asynchronous_operation, and always returns
+     * immediately.
+     *
+     * Errors, response timeouts and responses with
+     * smpp::command_status::rsyserr, smpp::command_status::rthrottled or
+     * smpp::command_status::rmsgqful are counted as failures of the endpoint,
+     * other responses as successes with their RTT.
+     *
+     * A request that fails with an error, including a response timeout, is
+     * retried once on the next healthy endpoint, so the whole operation can
+     * take up to twice the response timeout. Responses are never retried,
+     * whatever their command_status is. Note that a request that has timed
+     * out might have been delivered to the first endpoint, or its response
+     * lost in a broken connection, so the retry can submit it twice; use
+     * async_request of the endpoint itself if duplicates are not acceptable.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, pdu_variant, command_status)
+     * @endcode
+     * If all the circuits are open, operation completes with
+     * smpp::error::no_healthy_endpoint. If the response does not arrive in
+     * time, operation completes with smpp::error::response_timeout. The
+     * boost::system::error_code can contains network errors and cancellation
+     * error.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu The request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the response arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        CompletionToken&& token = asio::deferred_t{});
+
+private:
+    void
+    record_enquire_link_rtts();
+};
+
+template<typename Endpoint>
+endpoint_router<Endpoint>::endpoint_router(
+    std::vector<Endpoint*> endpoints,
+    std::chrono::milliseconds response_timeout,
+    circuit_breaker_options options)
+    : endpoints_{ std::move(endpoints) }
+    , executor_{ !endpoints_.empty()
+                     ? endpoints_.front()->get_executor()
+                     : throw std::invalid_argument{ "no endpoints" } }
+    , selector_{ endpoints_.size(), options }
+    , response_timeout_{ response_timeout }
+    , enquire_link_rtts_(endpoints_.size())
+{
+}
+
+template<typename Endpoint>
+endpoint_selector&
+endpoint_router<Endpoint>::selector() noexcept
+{
+    return selector_;
+}
+
+template<typename Endpoint>
+const endpoint_selector&
+endpoint_router<Endpoint>::selector() const noexcept
+{
+    return selector_;
+}
+
+template<typename Endpoint>
+void
+endpoint_router<Endpoint>::record_enquire_link_rtts()
+{
+    if constexpr(requires(const Endpoint& e) {
+                     { e.enquire_link_rtt() } -> std::same_as<clock::duration>;
+                 })
+    {
+        for(auto i = std::size_t{}; i < endpoints_.size(); i++)
+        {
+            const auto rtt = endpoints_[i]->enquire_link_rtt();
+            if(rtt != clock::duration{} && rtt != enquire_link_rtts_[i])
+            {
+                enquire_link_rtts_[i] = rtt;
+                selector_.record_rtt(i, rtt);
+            }
+        }
+    }
+}
+
+template<typename Endpoint>
+template<asio::completion_token_for<
+    void(boost::system::error_code, pdu_variant, command_status)>
+             CompletionToken>
+auto
+endpoint_router<Endpoint>::async_request(
+    const request_pdu auto& pdu,
+    CompletionToken&& token)
+{
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, pdu_variant, command_status)>(
+        [this,
+         &pdu,
+         index   = std::size_t{},
+         start   = clock::time_point{},
+         retried = false,
+         c       = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec = {},
+            pdu_variant response         = {},
+            command_status status        = {}) mutable
+        {
+            BOOST_ASIO_CORO_REENTER(c)
+            {
+                record_enquire_link_rtts();
+
+                {
+                    const auto selected = selector_.select();
+                    index = selected ? *selected : endpoints_.size();
+                }
+
+                if(index == endpoints_.size()) // no healthy endpoint
+                {
+                    // posted, so the completion never runs inline
+                    BOOST_ASIO_CORO_YIELD
+                    asio::post(std::move(self));
+                    return self.complete(error::no_healthy_endpoint, {}, {});
+                }
+
+                for(;;)
+                {
+                    start = clock::now();
+
+                    BOOST_ASIO_CORO_YIELD
+                    endpoints_[index]->async_request(
+                        pdu, response_timeout_, std::move(self));
+
+                    if(!!self.cancelled())
+                        return self.complete(
+                            asio::error::operation_aborted, {}, {});
+
+                    if(ec || status == command_status::rsyserr ||
+                       status == command_status::rthrottled ||
+                       status == command_status::rmsgqful)
+                        selector_.record_failure(index);
+                    else
+                        selector_.record_success(index, clock::now() - start);
+
+                    // only transport errors and timeouts are retried, once
+                    if(!ec || ec == error::serialization_failed || retried)
+                        break;
+
+                    {
+                        const auto selected = selector_.select_except(index);
+                        if(!selected)
+                            break;
+                        index = *selected;
+                    }
+
+                    retried = true;
+                }
+
+                self.complete(ec, std::move(response), status);
+            }
+        },
+        token,
+        executor_);
+}
+} // namespace smpp
@@ -0,0 +1,243 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <optional>
+#include <vector>
+
+namespace smpp
+{
+struct circuit_breaker_options
+{
+    // Consecutive failures that open the circuit
+    uint32_t failure_threshold{ 5 };
+
+    // Error rate that opens the circuit, in range [0, 1]
+    double error_rate_threshold{ 0.5 };
+
+    // Minimum samples before error_rate_threshold is taken into account
+    uint32_t minimum_samples{ 20 };
+
+    // The time an open circuit waits before letting a probe through
+    std::chrono::milliseconds open_duration{ 5000 };
+
+    // Weight of a new sample in the moving averages, in range (0, 1]
+    double ewma_weight{ 0.2 };
+
+    // How much the error rate inflates the RTT of an endpoint in selection
+    double error_penalty{ 4.0 };
+};
+
+enum class circuit_state
+{
+    closed,
+    open,
+    half_open
+};
+
+class endpoint_selector
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct endpoint_stats
+    {
+        double rtt{};
+        double error_rate{};
+        uint32_t consecutive_failures{};
+        uint32_t samples{};
+        bool open{ false };
+        clock::time_point probe_at{};
+    };
+
+    circuit_breaker_options options_;
+    std::vector<endpoint_stats> endpoints_;
+
+public:
+    /// Construct an endpoint_selector
+    /**
+     * @param size The number of endpoints
+     * @param options The options of the circuit breakers
+     */
+    explicit endpoint_selector(
+        std::size_t size,
+        circuit_breaker_options options = {})
+        : options_{ options }
+        , endpoints_(size)
+    {
+    }
+
+    /// Return the number of endpoints
+    std::size_t
+    size() const noexcept
+    {
+        return endpoints_.size();
+    }
+
+    /// Select the endpoint that the next message should be routed to
+    /**
+     * An open circuit that its open_duration has passed lets one message
+     * through as a probe, otherwise the closed endpoint with the lowest RTT,
+     * inflated by its error rate, is selected. Endpoints without any RTT
+     * sample are scored with the mean RTT of the measured endpoints, so they
+     * compete on their error rate instead of always winning.
+     *
+     * @return The index of the endpoint, or std::nullopt if all the circuits
+     * are open.
+     *
+     * @param now The current time.
+     */
+    std::optional<std::size_t>
+    select(clock::time_point now = clock::now())
+    {
+        return select_except(endpoints_.size(), now);
+    }
+
+    /// Select an endpoint other than the one that has just failed
+    /**
+     * Works like select, but never selects the endpoint at index excluded,
+     * which can be used for retrying a message on another endpoint.
+     *
+     * @return The index of the endpoint, or std::nullopt if all the other
+     * circuits are open.
+     *
+     * @param excluded The index of the endpoint that must not be selected.
+     * @param now The current time.
+     */
+    std::optional<std::size_t>
+    select_except(std::size_t excluded, clock::time_point now = clock::now())
+    {
+        auto selected = std::optional<std::size_t>{};
+        auto best     = double{};
+        const auto neutral = neutral_rtt();
+
+        for(auto i = std::size_t{}; i < endpoints_.size(); i++)
+        {
+            if(i == excluded)
+                continue;
+
+            auto& e = endpoints_[i];
+            if(e.open)
+            {
+                if(now < e.probe_at)
+                    continue;
+                e.probe_at = now + options_.open_duration;
+                return i;
+            }
+
+            const auto rtt   = e.rtt == 0.0 ? neutral : e.rtt;
+            const auto score =
+                rtt * (1.0 + options_.error_penalty * e.error_rate);
+            if(!selected || score < best)
+            {
+                selected = i;
+                best     = score;
+            }
+        }
+
+        return selected;
+    }
+
+    /// Record an RTT sample that is not the result of a routed message
+    /**
+     * This can be used for feeding the round trip time of enquire_link
+     * operations.
+     */
+    void
+    record_rtt(std::size_t index, clock::duration rtt)
+    {
+        auto& e           = endpoints_.at(index);
+        const auto sample = static_cast<double>(rtt.count());
+        e.rtt             = e.rtt == 0.0
+                        ? sample
+                        : e.rtt + (sample - e.rtt) * options_.ewma_weight;
+    }
+
+    /// Record a successful response of a routed message
+    void
+    record_success(std::size_t index, clock::duration rtt)
+    {
+        auto& e = endpoints_.at(index);
+        record_rtt(index, rtt);
+        e.consecutive_failures = 0;
+        e.samples++;
+        e.error_rate -= e.error_rate * options_.ewma_weight;
+
+        if(e.open) // the probe has succeeded
+        {
+            e.open       = false;
+            e.samples    = 0;
+            e.error_rate = 0.0;
+        }
+    }
+
+    /// Record a failure of a routed message
+    void
+    record_failure(std::size_t index, clock::time_point now = clock::now())
+    {
+        auto& e = endpoints_.at(index);
+        e.consecutive_failures++;
+        e.samples++;
+        e.error_rate += (1.0 - e.error_rate) * options_.ewma_weight;
+
+        if(e.open || e.consecutive_failures >= options_.failure_threshold ||
+           (e.samples >= options_.minimum_samples &&
+            e.error_rate >= options_.error_rate_threshold))
+        {
+            e.open     = true;
+            e.probe_at = now + options_.open_duration;
+        }
+    }
+
+    /// Return the circuit state of an endpoint
+    circuit_state
+    state(std::size_t index, clock::time_point now = clock::now()) const
+    {
+        const auto& e = endpoints_.at(index);
+        if(!e.open)
+            return circuit_state::closed;
+        return now < e.probe_at ? circuit_state::open
+                                : circuit_state::half_open;
+    }
+
+    /// Return the moving average of the RTT of an endpoint
+    clock::duration
+    rtt(std::size_t index) const
+    {
+        return clock::duration{
+            static_cast<clock::duration::rep>(endpoints_.at(index).rtt)
+        };
+    }
+
+    /// Return the moving average of the error rate of an endpoint
+    double
+    error_rate(std::size_t index) const
+    {
+        return endpoints_.at(index).error_rate;
+    }
+
+private:
+    double
+    neutral_rtt() const noexcept
+    {
+        auto sum      = double{};
+        auto measured = std::size_t{};
+        for(const auto& e : endpoints_)
+        {
+            if(e.rtt != 0.0)
+            {
+                sum += e.rtt;
+                measured++;
+            }
+        }
+
+        // any positive value lets the error rates decide when none is measured
+        return measured ? sum / static_cast<double>(measured) : 1.0;
+    }
+};
+} // namespace smpp
@@ -9,6 +9,11 @@ enum class error
     serialization_failed = 1,
     enquire_link_timeout,
     unbinded,
+    response_timeout,
+    no_healthy_endpoint,
+    delivery_not_tracked,
+    delivery_expired,
+    bind_rejected,
 };
 
 inline const boost::system::error_category&
@@ -35,6 +40,16 @@ error_category()
                 return "enquire_link timeout";
             case error::unbinded:
                 return "unbinded";
+            case error::response_timeout:
+                return "response timeout";
+            case error::no_healthy_endpoint:
+                return "no healthy endpoint";
+            case error::delivery_not_tracked:
+                return "delivery not tracked";
+            case error::delivery_expired:
+                return "delivery expired";
+            case error::bind_rejected:
+                return "bind rejected";
             default:
                 return "Unknown error";
             }
@@ -0,0 +1,167 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/net/session_pool.hpp>
+
+namespace smpp
+{
+namespace asio = boost::asio;
+
+/// A client session that survives the failures of its connection
+/**
+ * managed_session reconnects with backoff after network errors,
+ * enquire_link timeouts and unbinds, and rebinds with the original bind PDU.
+ * The requests that are waiting for their response when the connection fails
+ * are sent again on the new connection with new sequence numbers, and their
+ * completion handlers stay attached.
+ */
+class managed_session
+{
+    session_pool pool_;
+
+public:
+    using bind_pdu        = session_pool::bind_pdu;
+    using inbound_handler = session_pool::inbound_handler;
+
+    /// Construct a managed_session
+    /**
+     * The session is opened and bound by async_run.
+     *
+     * @param executor The executor that sessions would be created on
+     * @param endpoint The endpoint of the peer
+     * @param bind_pdu The bind request that the session would be bound with
+     * @param enquire_link_interval The interval for detecting inactivity and
+     * enquire_link operation
+     */
+    managed_session(
+        asio::any_io_executor executor,
+        asio::ip::tcp::endpoint endpoint,
+        bind_pdu bind_pdu,
+        std::chrono::seconds enquire_link_interval = std::chrono::seconds{
+            60 })
+        : pool_{ std::move(executor),
+                 std::move(endpoint),
+                 std::move(bind_pdu),
+                 1,
+                 enquire_link_interval }
+    {
+        pool_.set_replay_on_failure(true);
+    }
+
+    /// Set the backoff policy of reconnection
+    /**
+     * The max_attempts of the policy is ignored and reconnection attempts
+     * continue until async_run is cancelled.
+     */
+    void
+    set_reconnect_policy(retry_policy policy)
+    {
+        pool_.set_reconnect_policy(policy);
+    }
+
+    /// Set the handler of the inbound requests
+    /**
+     * See session_pool::set_inbound_handler.
+     */
+    void
+    set_inbound_handler(inbound_handler handler)
+    {
+        pool_.set_inbound_handler(std::move(handler));
+    }
+
+    /// Attach a delivery_tracker to the session
+    /**
+     * See session::set_delivery_tracker, it should be called before async_run.
+     */
+    void
+    set_delivery_tracker(delivery_tracker* tracker) noexcept
+    {
+        pool_.set_delivery_tracker(tracker);
+    }
+
+    /// Return true if the session is bound
+    bool
+    is_bound() const noexcept
+    {
+        return pool_.bound_sessions() != 0;
+    }
+
+    /// Return the number of requests waiting for their response
+    std::size_t
+    outstanding_requests() const noexcept
+    {
+        return pool_.outstanding_requests();
+    }
+
+    /// Start an asynchronous request
+    /**
+     * This function is used to asynchronously send a request PDU and wait for
+     * its response. If the session is not bound, it waits until the session is
+     * bound. If the connection fails before the response arrives, the request
+     * is sent again after the session is rebound. The peer might receive such
+     * a request twice if it has been received before the failure. It is an
+     * initiating function for an asynchronous_operation, and always returns
+     * immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, pdu_variant, command_status)
+     * @endcode
+     * If async_run completes before the response arrives, it completes with
+     * asio::error::operation_aborted.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu The request PDU, it should be kept alive until the operation
+     * completes
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the response arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        CompletionToken&& token = asio::deferred_t{})
+    {
+        return pool_.async_request(pdu, std::forward<CompletionToken>(token));
+    }
+
+    /// Start an asynchronous operation that runs the session
+    /**
+     * This function is used to open, bind and receive on the session, and to
+     * reconnect and rebind it when it fails. It is an initiating function for
+     * an asynchronous_operation, and always returns immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code) @endcode
+     * Completes with asio::error::operation_aborted after it is cancelled and
+     * the session is closed.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     * @li cancellation_type::partial
+     * @li cancellation_type::total
+     *
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the operation completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_run(CompletionToken&& token = asio::deferred_t{})
+    {
+        return pool_.async_run(std::forward<CompletionToken>(token));
+    }
+};
+} // namespace smpp
@@ -0,0 +1,213 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/common/request_pdu.hpp>
+#include <smpp/common/serialization.hpp>
+#include <smpp/net/detail/header_serialization.hpp>
+
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace smpp
+{
+namespace detail
+{
+template<typename R>
+struct field_limit;
+
+template<size_t MAXLEN>
+struct field_limit<c_octet_str<MAXLEN>>
+{
+    // One for null character
+    static constexpr std::size_t value = MAXLEN - 1;
+};
+
+template<size_t MAXLEN>
+struct field_limit<u8_octet_str<MAXLEN>>
+{
+    static constexpr std::size_t value = MAXLEN;
+};
+
+template<typename R, typename S, typename T>
+constexpr std::size_t
+field_limit_of(const mem_wrapper<R, S, T>&) noexcept
+{
+    return field_limit<R>::value;
+}
+} // namespace detail
+
+/// A pre-serialized request PDU whose dest_addr and short_message vary
+/**
+ * The fields of the prototype before dest_addr, between dest_addr and
+ * short_message, and after short_message are serialized once, on
+ * construction. A frame is then built with a few copies, from those parts,
+ * the dest_addr, the short_message and a header with the sequence_number,
+ * instead of serializing every field again. It is meant for campaigns that
+ * send the same message, or the same kind of message, to many destinations.
+ *
+ * @tparam PDU A request PDU with dest_addr and short_message fields, like
+ * submit_sm
+ */
+template<typename PDU>
+    requires request_pdu<PDU> && requires(PDU pdu) {
+        pdu.dest_addr;
+        pdu.short_message;
+    }
+class pdu_template
+{
+    static constexpr std::size_t header_length{ 16 };
+
+    std::vector<uint8_t> prefix_;
+    std::vector<uint8_t> middle_;
+    std::vector<uint8_t> suffix_;
+    std::size_t max_dest_addr_{};
+    std::size_t max_short_message_{};
+
+public:
+    /// Construct a pdu_template from a prototype
+    /**
+     * @throw std::length_error if a field of the prototype exceeds its limit.
+     *
+     * @param prototype The PDU whose fields, other than dest_addr and
+     * short_message, are used for all frames
+     */
+    explicit pdu_template(const PDU& prototype)
+    {
+        auto* part = &prefix_;
+
+        auto visit = [&](const auto& field)
+        {
+            if constexpr(std::is_same_v<
+                             std::decay_t<decltype(field.ptr)>,
+                             std::string PDU::*>)
+            {
+                if(field.ptr == &PDU::dest_addr)
+                {
+                    max_dest_addr_ = detail::field_limit_of(field);
+                    part           = &middle_;
+                    return;
+                }
+                if(field.ptr == &PDU::short_message)
+                {
+                    max_short_message_ = detail::field_limit_of(field);
+                    part               = &suffix_;
+                    return;
+                }
+            }
+            field.serialize_to(part, prototype);
+        };
+
+        [&]<size_t... Is>(std::index_sequence<Is...>)
+        {
+            (visit(std::get<Is>(detail::meta_holder<PDU>)), ...);
+        }(std::make_index_sequence<
+            std::tuple_size_v<decltype(detail::meta_holder<PDU>)>>());
+    }
+
+    /// Return the size of a frame
+    std::size_t
+    frame_size(std::string_view dest_addr, std::string_view short_message)
+        const noexcept
+    {
+        return header_length + prefix_.size() + dest_addr.size() + 1 +
+            middle_.size() + 1 + short_message.size() + suffix_.size();
+    }
+
+    /// Append a frame to a buffer
+    /**
+     * The frame is identical to the serialization of the prototype with the
+     * given dest_addr and short_message, header included.
+     *
+     * @throw std::length_error if dest_addr or short_message exceeds its limit.
+     *
+     * @param vec The vector that the frame would be appended to
+     * @param sequence_number The sequence_number of the frame
+     * @param dest_addr The dest_addr of the frame
+     * @param short_message The short_message of the frame
+     */
+    void
+    build(
+        std::vector<uint8_t>* vec,
+        uint32_t sequence_number,
+        std::string_view dest_addr,
+        std::string_view short_message) const
+    {
+        check_limits(dest_addr, short_message);
+
+        const auto begin = vec->size();
+        const auto size  = frame_size(dest_addr, short_message);
+        vec->reserve(begin + size);
+        vec->resize(begin + header_length);
+        append_body(vec, dest_addr, short_message);
+
+        detail::serialize_header(
+            std::span<uint8_t, header_length>{ vec->data() + begin,
+                                               header_length },
+            static_cast<uint32_t>(size),
+            PDU::command_id,
+            sequence_number);
+    }
+
+    /// Append the body of a frame to a buffer
+    /**
+     * Like build, but without the header, for buffers that have their header
+     * written separately.
+     *
+     * @throw std::length_error if dest_addr or short_message exceeds its limit.
+     *
+     * @param vec The vector that the body would be appended to
+     * @param dest_addr The dest_addr of the frame
+     * @param short_message The short_message of the frame
+     */
+    void
+    build_body(
+        std::vector<uint8_t>* vec,
+        std::string_view dest_addr,
+        std::string_view short_message) const
+    {
+        check_limits(dest_addr, short_message);
+
+        vec->reserve(
+            vec->size() + frame_size(dest_addr, short_message) -
+            header_length);
+        append_body(vec, dest_addr, short_message);
+    }
+
+private:
+    void
+    check_limits(std::string_view dest_addr, std::string_view short_message)
+        const
+    {
+        if(dest_addr.size() > max_dest_addr_)
+            throw std::length_error{
+                "c_octet_str exceed its limit, field_name:dest_addr"
+            };
+        if(short_message.size() > max_short_message_)
+            throw std::length_error{
+                "octet_str exceed its limit, field_name:short_message"
+            };
+    }
+
+    void
+    append_body(
+        std::vector<uint8_t>* vec,
+        std::string_view dest_addr,
+        std::string_view short_message) const
+    {
+        vec->insert(vec->end(), prefix_.begin(), prefix_.end());
+        vec->insert(vec->end(), dest_addr.begin(), dest_addr.end());
+        vec->push_back('\0');
+        vec->insert(vec->end(), middle_.begin(), middle_.end());
+        vec->push_back(static_cast<uint8_t>(short_message.size()));
+        vec->insert(vec->end(), short_message.begin(), short_message.end());
+        vec->insert(vec->end(), suffix_.begin(), suffix_.end());
+    }
+};
+} // namespace smpp
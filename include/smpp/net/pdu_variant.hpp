@@ -19,6 +19,10 @@ using pdu_variant = std::variant<
     bind_transceiver_resp,
     bind_transmitter,
     bind_transmitter_resp,
+    broadcast_sm,
+    broadcast_sm_resp,
+    cancel_broadcast_sm,
+    cancel_broadcast_sm_resp,
     cancel_sm,
     cancel_sm_resp,
     data_sm,
@@ -27,10 +31,14 @@ using pdu_variant = std::variant<
     deliver_sm_resp,
     generic_nack,
     outbind,
+    query_broadcast_sm,
+    query_broadcast_sm_resp,
     query_sm,
     query_sm_resp,
     replace_sm,
     replace_sm_resp,
+    submit_multi,
+    submit_multi_resp,
     submit_sm,
     submit_sm_resp,
     invalid_pdu>;
@@ -0,0 +1,348 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/param/npi.hpp>
+#include <smpp/param/ton.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace smpp
+{
+/// An immutable routing table that maps dest_addr prefixes to targets
+/**
+ * Prefixes are kept in a digit trie whose nodes have a bitmap of their
+ * children, which are stored next to each other, so a node takes 12 octets
+ * and a lookup takes one node per digit of the dest_addr. There is a trie for
+ * each combination of dest_addr_ton and dest_addr_npi that the rules use.
+ *
+ * @tparam Target The type of route targets, like an index of a session
+ */
+template<typename Target>
+class prefix_table
+{
+public:
+    struct rule
+    {
+        // std::nullopt matches any dest_addr_ton or dest_addr_npi
+        std::optional<smpp::ton> dest_addr_ton{};
+        std::optional<smpp::npi> dest_addr_npi{};
+        std::string prefix{};
+        Target target{};
+    };
+
+private:
+    struct node
+    {
+        uint32_t first_child;
+        uint32_t target; // index in targets_ plus one, zero for none
+        uint16_t children;
+    };
+
+    struct root
+    {
+        uint16_t ton; // any_value for any
+        uint16_t npi;
+        uint32_t node;
+    };
+
+    static constexpr uint16_t any_value{ 0x100 };
+
+    // std::popcount is a library call unless the target has an instruction
+    static constexpr auto popcounts = []
+    {
+        auto result = std::array<uint8_t, 1 << 10>{};
+        for(auto i = 0u; i < result.size(); i++)
+            result[i] = static_cast<uint8_t>(std::popcount(i));
+        return result;
+    }();
+
+    std::vector<node> nodes_;
+    std::vector<root> roots_;
+    std::vector<Target> targets_;
+
+public:
+    /// Construct an empty prefix_table
+    prefix_table() = default;
+
+    /// Construct a prefix_table from rules
+    /**
+     * A later rule replaces an earlier one with the same dest_addr_ton,
+     * dest_addr_npi and prefix.
+     *
+     * @throw std::invalid_argument if a prefix has a character other than
+     * decimal digits.
+     *
+     * @param rules The routing rules
+     */
+    explicit prefix_table(std::vector<rule> rules)
+    {
+        for(const auto& r : rules)
+            if(r.prefix.find_first_not_of("0123456789") != std::string::npos)
+                throw std::invalid_argument{ "prefix must be decimal digits" };
+
+        auto key = [](const rule& r)
+        {
+            return std::tuple{ r.dest_addr_ton ? uint16_t(*r.dest_addr_ton)
+                                               : any_value,
+                               r.dest_addr_npi ? uint16_t(*r.dest_addr_npi)
+                                               : any_value,
+                               std::string_view{ r.prefix } };
+        };
+
+        // shorter prefixes sort first, duplicates keep the last rule
+        std::stable_sort(
+            rules.begin(),
+            rules.end(),
+            [&](const rule& a, const rule& b) { return key(a) < key(b); });
+        rules.erase(
+            rules.begin(),
+            std::unique(
+                rules.rbegin(),
+                rules.rend(),
+                [&](const rule& a, const rule& b) { return key(a) == key(b); })
+                .base());
+
+        targets_.reserve(rules.size());
+        for(auto& r : rules)
+            targets_.push_back(std::move(r.target));
+
+        for(auto lo = std::size_t{}; lo < rules.size();)
+        {
+            auto hi = lo;
+            while(hi < rules.size() &&
+                  std::get<0>(key(rules[hi])) == std::get<0>(key(rules[lo])) &&
+                  std::get<1>(key(rules[hi])) == std::get<1>(key(rules[lo])))
+                hi++;
+
+            const auto node = static_cast<uint32_t>(nodes_.size());
+            const auto [ton, npi, prefix] = key(rules[lo]);
+            roots_.push_back({ ton, npi, node });
+            nodes_.push_back({});
+            fill(rules, node, lo, hi);
+            lo = hi;
+        }
+
+        // specific roots first, so they win ties
+        std::stable_sort(
+            roots_.begin(),
+            roots_.end(),
+            [](const root& a, const root& b)
+            {
+                return (a.ton == any_value) + (a.npi == any_value) <
+                    (b.ton == any_value) + (b.npi == any_value);
+            });
+    }
+
+    /// Return the number of rules
+    std::size_t
+    size() const noexcept
+    {
+        return targets_.size();
+    }
+
+    /// Return the target of the longest prefix that matches
+    /**
+     * When rules of different dest_addr_ton and dest_addr_npi combinations
+     * match with the same length, the more specific one wins.
+     *
+     * @return A pointer to the target, which remains valid as long as the
+     * prefix_table, or a null pointer if no rule matches.
+     *
+     * @param ton The dest_addr_ton
+     * @param npi The dest_addr_npi
+     * @param dest_addr The destination address
+     */
+    const Target*
+    lookup(smpp::ton ton, smpp::npi npi, std::string_view dest_addr)
+        const noexcept
+    {
+        auto best        = uint32_t{};
+        auto best_length = std::size_t{};
+
+        for(const auto& r : roots_)
+        {
+            if((r.ton != any_value && r.ton != uint16_t(ton)) ||
+               (r.npi != any_value && r.npi != uint16_t(npi)))
+                continue;
+
+            const auto* n = &nodes_[r.node];
+            auto target   = n->target;
+            auto length   = std::size_t{};
+            for(auto i = std::size_t{}; i < dest_addr.size(); i++)
+            {
+                const auto digit = static_cast<unsigned>(dest_addr[i] - '0');
+                if(digit > 9 || !(n->children >> digit & 1))
+                    break;
+
+                const auto preceding = n->children & ((1u << digit) - 1);
+                n = &nodes_[n->first_child + popcounts[preceding]];
+                if(n->target != 0)
+                {
+                    target = n->target;
+                    length = i + 1;
+                }
+            }
+
+            if(target != 0 && (best == 0 || length > best_length))
+            {
+                best        = target;
+                best_length = length;
+            }
+        }
+
+        return best != 0 ? &targets_[best - 1] : nullptr;
+    }
+
+private:
+    // Builds the trie of rules[lo, hi) under nodes_[root] breadth-first, so
+    // the nodes of the upper levels, which every lookup visits, are together
+    void
+    fill(
+        const std::vector<rule>& rules,
+        uint32_t root,
+        std::size_t lo,
+        std::size_t hi)
+    {
+        struct pending
+        {
+            uint32_t node;
+            std::size_t lo; // rules[lo, hi) share their first depth digits
+            std::size_t hi;
+            std::size_t depth;
+        };
+
+        auto queue = std::deque<pending>{ { root, lo, hi, 0 } };
+        while(!queue.empty())
+        {
+            auto [n, lo, hi, depth] = queue.front();
+            queue.pop_front();
+
+            if(lo < hi && rules[lo].prefix.size() == depth)
+                nodes_[n].target = static_cast<uint32_t>(lo++) + 1;
+
+            auto children = uint16_t{};
+            for(auto i = lo; i < hi; i++)
+                children |= 1u << (rules[i].prefix[depth] - '0');
+            if(children == 0)
+                continue;
+
+            // children are allocated together so they are adjacent
+            const auto first_child = static_cast<uint32_t>(nodes_.size());
+
+            nodes_[n].children    = children;
+            nodes_[n].first_child = first_child;
+            nodes_.resize(nodes_.size() + std::popcount(children));
+
+            auto child = first_child;
+            for(auto i = lo; i < hi; child++)
+            {
+                const auto digit = rules[i].prefix[depth];
+
+                auto j = i;
+                while(j < hi && rules[j].prefix[depth] == digit)
+                    j++;
+                queue.push_back({ child, i, j, depth + 1 });
+                i = j;
+            }
+        }
+    }
+};
+
+/// Publishes prefix_tables to concurrent readers by read-copy-update
+/**
+ * A new prefix_table is built aside on a configuration reload and swapped in
+ * with update. Each thread looks up through its own reader, which holds the
+ * table that it uses and checks an atomic version on each lookup, so lookups
+ * don't lock or write shared memory; a reader only locks when it switches to
+ * a new table. An old table is freed when its last reader switches.
+ *
+ * @tparam Target The type of route targets, like an index of a session
+ */
+template<typename Target>
+class prefix_router
+{
+    mutable std::mutex mutex_;
+    std::shared_ptr<const prefix_table<Target>> table_;
+    std::atomic<uint64_t> version_{};
+
+public:
+    /// Looks up the table of a prefix_router, it is not thread-safe itself
+    class reader
+    {
+        const prefix_router* router_;
+        std::shared_ptr<const prefix_table<Target>> table_;
+        uint64_t version_{};
+
+    public:
+        explicit reader(const prefix_router& router)
+            : router_{ &router }
+        {
+            refresh();
+        }
+
+        /// Return the target of the longest prefix that matches
+        /**
+         * @return A pointer to the target, which remains valid until the next
+         * lookup, or a null pointer if no rule matches.
+         */
+        const Target*
+        lookup(smpp::ton ton, smpp::npi npi, std::string_view dest_addr)
+        {
+            if(router_->version_.load(std::memory_order_acquire) != version_)
+                refresh();
+            return table_->lookup(ton, npi, dest_addr);
+        }
+
+    private:
+        void
+        refresh()
+        {
+            auto lock = std::lock_guard{ router_->mutex_ };
+            version_  = router_->version_.load(std::memory_order_relaxed);
+            table_    = router_->table_;
+        }
+    };
+
+    /// Construct a prefix_router with a prefix_table
+    explicit prefix_router(prefix_table<Target> table = {})
+        : table_{ std::make_shared<const prefix_table<Target>>(
+              std::move(table)) }
+    {
+    }
+
+    /// Replace the prefix_table, readers switch on their next lookup
+    void
+    update(prefix_table<Target> table)
+    {
+        auto next =
+            std::make_shared<const prefix_table<Target>>(std::move(table));
+        auto lock = std::lock_guard{ mutex_ };
+        table_.swap(next);
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    /// Return the current prefix_table
+    std::shared_ptr<const prefix_table<Target>>
+    table() const
+    {
+        auto lock = std::lock_guard{ mutex_ };
+        return table_;
+    }
+};
+} // namespace smpp
@@ -0,0 +1,656 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/net/detail/sequence_remap.hpp>
+#include <smpp/net/session.hpp>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace smpp
+{
+namespace asio = boost::asio;
+
+/// Return the dest_addr of an encoded submit_sm, data_sm or deliver_sm body
+/**
+ * Only the fields before dest_addr are scanned, so a route_handler can route
+ * by destination without deserializing the PDU.
+ *
+ * @return A view into the body, or std::nullopt if the PDU is of another
+ * type or is malformed.
+ *
+ * @param command_id The command_id of the PDU
+ * @param body The encoded body of the PDU
+ */
+inline std::optional<std::string_view>
+peek_dest_addr(command_id command_id, std::span<const uint8_t> body) noexcept
+{
+    if(command_id != smpp::command_id::submit_sm &&
+       command_id != smpp::command_id::data_sm &&
+       command_id != smpp::command_id::deliver_sm)
+        return std::nullopt;
+
+    auto pos = body.begin();
+
+    // service_type, then ton and npi and source_addr, then ton and npi
+    for(auto i = 0; i < 2; i++)
+    {
+        pos = std::find(pos, body.end(), '\0');
+        if(body.end() - pos < 3)
+            return std::nullopt;
+        pos += 3;
+    }
+
+    const auto null = std::find(pos, body.end(), '\0');
+    if(null == body.end())
+        return std::nullopt;
+    return std::string_view{ reinterpret_cast<const char*>(&*pos),
+                             static_cast<std::size_t>(null - pos) };
+}
+
+/// Relays the PDUs of an ESME to upstream SMSC sessions
+/**
+ * The relay answers the bind of the ESME itself, then forwards its requests
+ * to the upstream sessions and the requests of the upstream sessions, like
+ * deliver_sm, to the ESME. PDUs are received with async_receive_raw and sent
+ * with async_send_raw, so only the header is rewritten, with the
+ * sequence_number of the other session, and the responses are mapped back
+ * through a remap table per direction.
+ *
+ * The upstream sessions should be bound, and all the sessions should be used
+ * only by the relay and share a single-threaded executor. When the relay
+ * stops, the upstream sessions are unbound before they are closed.
+ */
+class relay
+{
+public:
+    using bind_handler = std::function<
+        command_status(std::string_view system_id, std::string_view password)>;
+
+    using route_handler = std::function<
+        std::size_t(command_id command_id, std::span<const uint8_t> body)>;
+
+private:
+    struct upstream_ref
+    {
+        uint32_t sequence_number;
+        uint32_t index;
+    };
+
+    std::shared_ptr<session> downstream_;
+    std::vector<std::shared_ptr<session>> upstreams_;
+    std::string system_id_;
+    bind_handler bind_handler_;
+    route_handler route_handler_;
+    std::size_t next_upstream_{};
+
+    // ESME sequence_numbers by the sequence_numbers of each upstream
+    std::vector<detail::sequence_remap<uint32_t>> upstream_remaps_;
+    // upstream sequence_numbers by the sequence_numbers of the ESME
+    detail::sequence_remap<upstream_ref> downstream_remap_;
+
+    asio::steady_timer run_cv_;
+    std::size_t running_{};
+    boost::system::error_code error_{};
+    std::chrono::steady_clock::duration unbind_timeout_{
+        std::chrono::seconds{ 5 }
+    };
+
+public:
+    /// Construct a relay
+    /**
+     * @param downstream The session of the ESME, before it binds
+     * @param upstreams The bound sessions of the SMSCs
+     * @param system_id The system_id that is sent in bind responses
+     */
+    relay(
+        std::shared_ptr<session> downstream,
+        std::vector<std::shared_ptr<session>> upstreams,
+        std::string system_id);
+
+    /// Set the handler that accepts or rejects the bind of the ESME
+    /**
+     * The bind is accepted with any system_id and password by default.
+     */
+    void
+    set_bind_handler(bind_handler handler);
+
+    /// Set the handler that chooses the upstream session of each request
+    /**
+     * The handler returns the index of an upstream session, an index out of
+     * range rejects the request with its response PDU, like submit_sm_resp,
+     * and smpp::command_status::rinvdstadr. Requests are distributed in round
+     * robin by default.
+     */
+    void
+    set_route_handler(route_handler handler);
+
+    /// Set the time to wait for the unbind_resp of the upstream sessions
+    /**
+     * The upstream sessions that haven't responded to the unbind when the
+     * time is up are closed without it. The default is 5 seconds.
+     */
+    void
+    set_unbind_timeout(std::chrono::steady_clock::duration timeout);
+
+    /// Return the number of requests waiting for their response
+    std::size_t
+    outstanding_requests() const noexcept;
+
+    /// Start an asynchronous operation that relays PDUs
+    /**
+     * This function is used to asynchronously relay PDUs between the ESME and
+     * the upstream sessions. It is an initiating function for an
+     * asynchronous_operation, and always returns immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code) @endcode
+     * The operation completes when any of the sessions fails, with the error
+     * of the first one, after unbinding the upstream sessions and closing all
+     * of them. If the bind of the ESME is
+     * rejected, operation completes with smpp::error::bind_rejected. Upon a
+     * graceful unbind of the ESME, operation completes with
+     * smpp::error::unbinded.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     * @li cancellation_type::partial
+     * @li cancellation_type::total
+     *
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the relay stops
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_run(CompletionToken&& token = asio::deferred_t{});
+
+private:
+    std::size_t
+    route(command_id command_id, std::span<const uint8_t> body);
+
+    void
+    start(auto op);
+
+    void
+    stop();
+
+    void
+    close();
+
+    static bool
+    expects_response(command_id command_id) noexcept;
+
+    class downstream_op;
+    class upstream_op;
+};
+
+inline relay::relay(
+    std::shared_ptr<session> downstream,
+    std::vector<std::shared_ptr<session>> upstreams,
+    std::string system_id)
+    : downstream_{ std::move(downstream) }
+    , upstreams_{ std::move(upstreams) }
+    , system_id_{ std::move(system_id) }
+    , upstream_remaps_(upstreams_.size())
+    , run_cv_{ downstream_->next_layer().get_executor(),
+               asio::steady_timer::time_point::max() }
+{
+}
+
+inline void
+relay::set_bind_handler(bind_handler handler)
+{
+    bind_handler_ = std::move(handler);
+}
+
+inline void
+relay::set_route_handler(route_handler handler)
+{
+    route_handler_ = std::move(handler);
+}
+
+inline void
+relay::set_unbind_timeout(std::chrono::steady_clock::duration timeout)
+{
+    unbind_timeout_ = timeout;
+}
+
+inline std::size_t
+relay::outstanding_requests() const noexcept
+{
+    auto outstanding = downstream_remap_.size();
+    for(const auto& remap : upstream_remaps_)
+        outstanding += remap.size();
+    return outstanding;
+}
+
+inline std::size_t
+relay::route(command_id command_id, std::span<const uint8_t> body)
+{
+    if(route_handler_)
+        return route_handler_(command_id, body);
+    if(upstreams_.empty())
+        return 0;
+    return next_upstream_++ % upstreams_.size();
+}
+
+inline bool
+relay::expects_response(command_id command_id) noexcept
+{
+    // no remap is kept for requests without a response
+    return command_id != command_id::alert_notification;
+}
+
+void
+relay::start(auto op)
+{
+    auto on_exit = [this](boost::system::error_code ec)
+    {
+        if(!error_)
+            error_ = ec;
+        running_--;
+        run_cv_.cancel();
+    };
+
+    running_++;
+    asio::async_compose<decltype(on_exit), void(boost::system::error_code)>(
+        std::move(op), on_exit, run_cv_);
+}
+
+inline void
+relay::stop()
+{
+    auto ec = boost::system::error_code{};
+    downstream_->next_layer().close(ec);
+
+    // the upstream ops exit when the unbind_resp arrives
+    for(auto& upstream : upstreams_)
+        upstream->async_send_unbind(
+            [upstream](boost::system::error_code) {});
+}
+
+inline void
+relay::close()
+{
+    auto ec = boost::system::error_code{};
+    downstream_->next_layer().close(ec);
+    for(auto& upstream : upstreams_)
+        upstream->next_layer().close(ec);
+}
+
+class relay::upstream_op
+{
+    relay* r_;
+    uint32_t index_;
+    command_id command_id_{};
+    std::span<const uint8_t> body_{};
+    uint32_t sequence_number_{};
+    uint32_t upstream_sequence_number_{};
+    command_status command_status_{};
+    asio::coroutine c_{};
+
+public:
+    upstream_op(relay* r, uint32_t index)
+        : r_{ r }
+        , index_{ index }
+    {
+    }
+
+    void
+    operator()(
+        auto&& self,
+        boost::system::error_code ec,
+        smpp::command_id command_id,
+        std::span<const uint8_t> body,
+        uint32_t sequence_number,
+        smpp::command_status command_status)
+    {
+        command_id_      = command_id;
+        body_            = body;
+        sequence_number_ = sequence_number;
+        command_status_  = command_status;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(auto&& self, boost::system::error_code ec, uint32_t sent_seq)
+    {
+        sequence_number_ = sent_seq;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(auto&& self, boost::system::error_code ec = {})
+    {
+        auto& upstream   = *r_->upstreams_[index_];
+        auto& downstream = *r_->downstream_;
+
+        BOOST_ASIO_CORO_REENTER(c_)
+        for(;;)
+        {
+            BOOST_ASIO_CORO_YIELD
+            upstream.async_receive_raw(std::move(self));
+            if(ec)
+                return self.complete(ec);
+
+            if(is_response(command_id_))
+            {
+                if(auto esme_sequence_number =
+                       r_->upstream_remaps_[index_].extract(sequence_number_))
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    downstream.async_send_raw(
+                        command_id_,
+                        asio::buffer(body_.data(), body_.size()),
+                        *esme_sequence_number,
+                        command_status_,
+                        std::move(self));
+                    if(ec)
+                        return self.complete(ec);
+                }
+                continue;
+            }
+
+            upstream_sequence_number_ = sequence_number_;
+
+            BOOST_ASIO_CORO_YIELD
+            downstream.async_send_raw(
+                command_id_,
+                asio::buffer(body_.data(), body_.size()),
+                std::move(self));
+            if(ec)
+                return self.complete(ec);
+
+            if(expects_response(command_id_))
+                r_->downstream_remap_.insert(
+                    sequence_number_, { upstream_sequence_number_, index_ });
+        }
+    }
+};
+
+class relay::downstream_op
+{
+    relay* r_;
+    std::variant<
+        bind_transmitter_resp,
+        bind_receiver_resp,
+        bind_transceiver_resp>
+        bind_resp_{};
+    pdu_variant pdu_{};
+    command_id command_id_{};
+    std::span<const uint8_t> body_{};
+    uint32_t sequence_number_{};
+    uint32_t esme_sequence_number_{};
+    command_status command_status_{};
+    std::size_t upstream_{};
+    asio::coroutine c_{};
+
+public:
+    explicit downstream_op(relay* r)
+        : r_{ r }
+    {
+    }
+
+    void
+    operator()(
+        auto&& self,
+        boost::system::error_code ec,
+        pdu_variant pdu,
+        uint32_t sequence_number,
+        smpp::command_status command_status)
+    {
+        pdu_             = std::move(pdu);
+        sequence_number_ = sequence_number;
+        command_status_  = command_status;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(
+        auto&& self,
+        boost::system::error_code ec,
+        smpp::command_id command_id,
+        std::span<const uint8_t> body,
+        uint32_t sequence_number,
+        smpp::command_status command_status)
+    {
+        command_id_      = command_id;
+        body_            = body;
+        sequence_number_ = sequence_number;
+        command_status_  = command_status;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(auto&& self, boost::system::error_code ec, uint32_t sent_seq)
+    {
+        sequence_number_ = sent_seq;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(auto&& self, boost::system::error_code ec = {})
+    {
+        static const auto nack = generic_nack{};
+        auto& downstream       = *r_->downstream_;
+
+        BOOST_ASIO_CORO_REENTER(c_)
+        {
+            BOOST_ASIO_CORO_YIELD
+            downstream.async_receive(std::move(self));
+            if(ec)
+                return self.complete(ec);
+
+            if(!accept_bind())
+            {
+                BOOST_ASIO_CORO_YIELD
+                downstream.async_send(
+                    nack,
+                    sequence_number_,
+                    command_status::rinvbndsts,
+                    std::move(self));
+                return self.complete(error::bind_rejected);
+            }
+
+            BOOST_ASIO_CORO_YIELD
+            std::visit(
+                [&](const auto& resp)
+                {
+                    downstream.async_send(
+                        resp,
+                        sequence_number_,
+                        command_status_,
+                        std::move(self));
+                },
+                bind_resp_);
+            if(ec)
+                return self.complete(ec);
+            if(command_status_ != command_status::rok)
+                return self.complete(error::bind_rejected);
+
+            for(auto i = uint32_t{}; i < r_->upstreams_.size(); i++)
+                r_->start(upstream_op{ r_, i });
+
+            for(;;)
+            {
+                BOOST_ASIO_CORO_YIELD
+                downstream.async_receive_raw(std::move(self));
+                if(ec)
+                    return self.complete(ec);
+
+                if(is_response(command_id_))
+                {
+                    auto ref = r_->downstream_remap_.extract(sequence_number_);
+                    if(ref)
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        r_->upstreams_[ref->index]->async_send_raw(
+                            command_id_,
+                            asio::buffer(body_.data(), body_.size()),
+                            ref->sequence_number,
+                            command_status_,
+                            std::move(self));
+                        if(ec)
+                            return self.complete(ec);
+                    }
+                    continue;
+                }
+
+                upstream_ = r_->route(command_id_, body_);
+                if(upstream_ >= r_->upstreams_.size())
+                {
+                    if(!expects_response(command_id_))
+                        continue;
+
+                    BOOST_ASIO_CORO_YIELD
+                    reject(std::move(self), command_status::rinvdstadr);
+                    if(ec)
+                        return self.complete(ec);
+                    continue;
+                }
+
+                esme_sequence_number_ = sequence_number_;
+
+                BOOST_ASIO_CORO_YIELD
+                r_->upstreams_[upstream_]->async_send_raw(
+                    command_id_,
+                    asio::buffer(body_.data(), body_.size()),
+                    std::move(self));
+                if(ec)
+                    return self.complete(ec);
+
+                if(expects_response(command_id_))
+                    r_->upstream_remaps_[upstream_].insert(
+                        sequence_number_, esme_sequence_number_);
+            }
+        }
+    }
+
+private:
+    // Answers the request with its response PDU, or with a generic_nack if
+    // its command_id is unknown
+    void
+    reject(auto&& self, smpp::command_status command_status)
+    {
+        const auto response_id = static_cast<smpp::command_id>(
+            static_cast<uint32_t>(command_id_) | 0x80000000);
+
+        pdu_ = generic_nack{};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>)
+        {
+            ((response_id ==
+                      std::variant_alternative_t<Is, pdu_variant>::command_id &&
+                  (pdu_.emplace<Is>(), true)) ||
+             ...);
+        }(std::make_index_sequence<
+            std::variant_size_v<pdu_variant> -
+            1>()); // -1 because of invalid_pdu
+
+        std::visit(
+            [&](const auto& pdu)
+            {
+                if constexpr(response_pdu<std::decay_t<decltype(pdu)>>)
+                    r_->downstream_->async_send(
+                        pdu, sequence_number_, command_status, std::move(self));
+            },
+            pdu_);
+    }
+
+    // Decides the bind_resp_ and its command_status_ for a bind request
+    bool
+    accept_bind()
+    {
+        auto check = [&](const auto& bind)
+        {
+            command_status_ = r_->bind_handler_
+                ? r_->bind_handler_(bind.system_id, bind.password)
+                : command_status::rok;
+        };
+
+        if(auto* bind = std::get_if<bind_transmitter>(&pdu_))
+        {
+            check(*bind);
+            bind_resp_ = bind_transmitter_resp{ .system_id = r_->system_id_ };
+            return true;
+        }
+        if(auto* bind = std::get_if<bind_receiver>(&pdu_))
+        {
+            check(*bind);
+            bind_resp_ = bind_receiver_resp{ .system_id = r_->system_id_ };
+            return true;
+        }
+        if(auto* bind = std::get_if<bind_transceiver>(&pdu_))
+        {
+            check(*bind);
+            bind_resp_ = bind_transceiver_resp{ .system_id = r_->system_id_ };
+            return true;
+        }
+        return false;
+    }
+};
+
+template<
+    asio::completion_token_for<void(boost::system::error_code)> CompletionToken>
+auto
+relay::async_run(CompletionToken&& token)
+{
+    return asio::
+        async_compose<decltype(token), void(boost::system::error_code)>(
+            [this, c = asio::coroutine{}](
+                auto&& self, boost::system::error_code ec = {}) mutable
+            {
+                BOOST_ASIO_CORO_REENTER(c)
+                {
+                    self.reset_cancellation_state(
+                        asio::enable_total_cancellation());
+
+                    error_ = {};
+                    run_cv_.expires_at(asio::steady_timer::time_point::max());
+                    start(downstream_op{ this });
+
+                    // woken up by the first exit or by cancellation
+                    BOOST_ASIO_CORO_YIELD
+                    run_cv_.async_wait(std::move(self));
+
+                    stop();
+                    run_cv_.expires_after(unbind_timeout_);
+                    while(running_ != 0)
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        run_cv_.async_wait(std::move(self));
+
+                        // the unbind_resp hasn't arrived in time
+                        if(!ec)
+                            close();
+                    }
+                    close();
+
+                    self.complete(
+                        error_ ? error_ : asio::error::operation_aborted);
+                }
+            },
+            token,
+            run_cv_);
+}
+} // namespace smpp
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+
+namespace smpp
+{
+struct retry_policy
+{
+    // Maximum number of attempts, including the first one
+    uint32_t max_attempts{ 5 };
+
+    // Delay before the second attempt
+    std::chrono::milliseconds initial_backoff{ 1000 };
+
+    // Upper bound of the delay between two attempts
+    std::chrono::milliseconds max_backoff{ 60000 };
+
+    // Growth factor of the delay after each attempt
+    double multiplier{ 2.0 };
+
+    // Fraction of the delay that is randomized, in range [0, 1]
+    double jitter{ 0.5 };
+
+    bool
+    operator==(const retry_policy&) const = default;
+
+    /// Compute the delay before the next attempt
+    /**
+     * The delay grows exponentially from initial_backoff and is capped at
+     * max_backoff, then the jitter fraction of it is scaled by the random
+     * value, so the result is in range [delay * (1 - jitter), delay].
+     *
+     * @return The delay before the next attempt.
+     *
+     * @param attempt The number of attempts that have been made so far,
+     * starting from 1.
+     * @param random A uniformly distributed random value in range [0, 1).
+     */
+    std::chrono::milliseconds
+    backoff(uint32_t attempt, double random) const
+    {
+        const auto exponent = static_cast<double>(std::max(attempt, 1U) - 1);
+        const auto delay    = std::min(
+            static_cast<double>(initial_backoff.count()) *
+                std::pow(multiplier, exponent),
+            static_cast<double>(max_backoff.count()));
+        const auto jittered =
+            delay * (1.0 - std::clamp(jitter, 0.0, 1.0) * (1.0 - random));
+
+        return std::chrono::milliseconds{
+            static_cast<std::chrono::milliseconds::rep>(jittered)
+        };
+    }
+};
+} // namespace smpp
@@ -0,0 +1,386 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/net/error.hpp>
+#include <smpp/net/retry_policy.hpp>
+#include <smpp/net/session.hpp>
+
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+
+namespace smpp
+{
+namespace asio = boost::asio;
+class retry_scheduler
+{
+    struct parked_request
+    {
+        asio::steady_timer cv;
+        bool released{ false };
+    };
+
+    using clock      = std::chrono::steady_clock;
+    using queue_type = std::multimap<clock::time_point, parked_request*>;
+
+    session* session_;
+    std::chrono::milliseconds response_timeout_;
+    std::map<command_status, retry_policy> policies_;
+    std::optional<retry_policy> timeout_policy_;
+    std::size_t batch_size_{ 64 };
+    std::chrono::milliseconds batch_interval_{ 100 };
+    asio::steady_timer timer_;
+    queue_type queue_;
+    clock::time_point not_before_{};
+    std::minstd_rand rng_{ std::random_device{}() };
+
+public:
+    /// Construct a retry_scheduler on top of a session
+    /**
+     * This constructor creates a retry_scheduler that retries requests which
+     * complete with smpp::command_status::rthrottled,
+     * smpp::command_status::rmsgqful and smpp::command_status::rsyserr, or
+     * time out, using the default retry_policy.
+     *
+     * @param session The session that requests would be sent over, it should
+     * outlive the retry_scheduler
+     * @param response_timeout The time to wait for the response of each
+     * attempt
+     */
+    explicit retry_scheduler(
+        session& session,
+        std::chrono::milliseconds response_timeout = std::chrono::seconds{
+            30 });
+
+    /// Set the retry policy of a command_status
+    /**
+     * @param command_status The command_status of the response that should be
+     * retried
+     * @param policy The retry policy
+     */
+    void
+    set_policy(command_status command_status, retry_policy policy);
+
+    /// Remove the retry policy of a command_status
+    /**
+     * Responses with this command_status would be treated as final.
+     *
+     * @param command_status The command_status of the response
+     */
+    void
+    remove_policy(command_status command_status);
+
+    /// Set the retry policy of response timeouts
+    /**
+     * @param policy The retry policy, std::nullopt disables retries on
+     * response timeouts
+     */
+    void
+    set_timeout_policy(std::optional<retry_policy> policy);
+
+    /// Set the limits of releasing due retries
+    /**
+     * At most batch_size retries are released at once and the next batch is
+     * released after batch_interval, which prevents a burst of retries after
+     * a temporary failure of the peer.
+     *
+     * @param batch_size Maximum number of retries released at once
+     * @param batch_interval The interval between two batches
+     */
+    void
+    set_batch_limits(
+        std::size_t batch_size,
+        std::chrono::milliseconds batch_interval);
+
+    /// Return the number of requests that are waiting for a retry
+    std::size_t
+    pending_retries() const noexcept;
+
+    /// Start an asynchronous request with automatic retries
+    /**
+     * This function is used to asynchronously send a request PDU and wait for
+     * its final response. The first attempt is sent immediately, subsequent
+     * attempts wait in the retry queue until they are released by async_run.
+     * It is an initiating function for an asynchronous_operation, and always
+     * returns immediately.
+     *
+     * The PDU should remain valid until the operation completes.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, pdu_variant, command_status)
+     * @endcode
+     * Completes with the first response that has no retry policy or when
+     * attempts are exhausted, in which case the last response would be
+     * returned. If the last attempt times out, operation completes with
+     * smpp::error::response_timeout. The boost::system::error_code can
+     * contains network errors and cancellation error.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu The request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the request completes
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous operation that releases due retries
+    /**
+     * This function is used to run the shared timer of retry_scheduler, which
+     * releases the due retries in batches. It is an initiating function for an
+     * asynchronous_operation, and always returns immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code) @endcode
+     * The boost::system::error_code can contains cancellation error.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     * @li cancellation_type::partial
+     * @li cancellation_type::total
+     *
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the operation completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_run(CompletionToken&& token = asio::deferred_t{});
+
+private:
+    const retry_policy*
+    find_policy(command_status command_status, bool timed_out) const;
+
+    queue_type::iterator
+    park(parked_request* parked, clock::time_point due);
+
+    void
+    release_due();
+};
+
+inline retry_scheduler::retry_scheduler(
+    session& session,
+    std::chrono::milliseconds response_timeout)
+    : session_{ &session }
+    , response_timeout_{ response_timeout }
+    , policies_{ { command_status::rthrottled, retry_policy{} },
+                 { command_status::rmsgqful, retry_policy{} },
+                 { command_status::rsyserr, retry_policy{} } }
+    , timeout_policy_{ retry_policy{} }
+    , timer_{ session.next_layer().get_executor(),
+              asio::steady_timer::time_point::max() }
+{
+}
+
+inline void
+retry_scheduler::set_policy(command_status command_status, retry_policy policy)
+{
+    policies_[command_status] = policy;
+}
+
+inline void
+retry_scheduler::remove_policy(command_status command_status)
+{
+    policies_.erase(command_status);
+}
+
+inline void
+retry_scheduler::set_timeout_policy(std::optional<retry_policy> policy)
+{
+    timeout_policy_ = policy;
+}
+
+inline void
+retry_scheduler::set_batch_limits(
+    std::size_t batch_size,
+    std::chrono::milliseconds batch_interval)
+{
+    batch_size_     = std::max<std::size_t>(batch_size, 1);
+    batch_interval_ = batch_interval;
+}
+
+inline std::size_t
+retry_scheduler::pending_retries() const noexcept
+{
+    return queue_.size();
+}
+
+inline const retry_policy*
+retry_scheduler::find_policy(command_status command_status, bool timed_out)
+    const
+{
+    if(timed_out)
+        return timeout_policy_ ? &*timeout_policy_ : nullptr;
+
+    const auto it = policies_.find(command_status);
+    return it != policies_.end() ? &it->second : nullptr;
+}
+
+inline retry_scheduler::queue_type::iterator
+retry_scheduler::park(parked_request* parked, clock::time_point due)
+{
+    parked->released = false;
+    auto it          = queue_.emplace(due, parked);
+
+    // wakes up async_run if this retry is due before the armed expiry
+    if(due < timer_.expiry())
+        timer_.cancel();
+
+    return it;
+}
+
+inline void
+retry_scheduler::release_due()
+{
+    const auto now = clock::now();
+    auto released  = std::size_t{};
+
+    while(!queue_.empty() && queue_.begin()->first <= now &&
+          released < batch_size_)
+    {
+        queue_.begin()->second->released = true;
+        queue_.begin()->second->cv.cancel();
+        queue_.erase(queue_.begin());
+        released++;
+    }
+
+    not_before_ =
+        released == batch_size_ ? now + batch_interval_ : clock::time_point{};
+}
+
+template<asio::completion_token_for<
+    void(boost::system::error_code, pdu_variant, command_status)>
+             CompletionToken>
+auto
+retry_scheduler::async_request(
+    const request_pdu auto& pdu,
+    CompletionToken&& token)
+{
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, pdu_variant, command_status)>(
+        [this,
+         &pdu,
+         attempt = uint32_t{},
+         parked  = std::unique_ptr<parked_request>{},
+         it      = queue_type::iterator{},
+         c       = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec  = {},
+            pdu_variant response          = {},
+            command_status command_status = {}) mutable
+        {
+            BOOST_ASIO_CORO_REENTER(c)
+            for(;;)
+            {
+                attempt++;
+                BOOST_ASIO_CORO_YIELD
+                // the timeout only applies to the response wait, a write is
+                // never aborted in the middle of a frame
+                session_->async_request(
+                    pdu, response_timeout_, std::move(self));
+
+                {
+                    const auto timed_out = ec == error::response_timeout;
+
+                    if(ec && !timed_out)
+                        return self.complete(ec, std::move(response), {});
+
+                    const auto* policy = find_policy(command_status, timed_out);
+                    if(policy == nullptr || attempt >= policy->max_attempts)
+                    {
+                        if(timed_out)
+                            return self.complete(
+                                error::response_timeout, {}, {});
+                        return self.complete(
+                            {}, std::move(response), command_status);
+                    }
+
+                    if(!parked)
+                        parked.reset(new parked_request{ asio::steady_timer{
+                            session_->next_layer().get_executor(),
+                            asio::steady_timer::time_point::max() } });
+
+                    it = park(
+                        parked.get(),
+                        clock::now() +
+                            policy->backoff(
+                                attempt,
+                                std::uniform_real_distribution<>{}(rng_)));
+                }
+
+                BOOST_ASIO_CORO_YIELD
+                parked->cv.async_wait(std::move(self));
+
+                if(!parked->released)
+                {
+                    queue_.erase(it);
+                    return self.complete(
+                        ec ? ec : asio::error::operation_aborted, {}, {});
+                }
+            }
+        },
+        token,
+        session_->next_layer());
+}
+
+template<
+    asio::completion_token_for<void(boost::system::error_code)> CompletionToken>
+auto
+retry_scheduler::async_run(CompletionToken&& token)
+{
+    return asio::
+        async_compose<decltype(token), void(boost::system::error_code)>(
+            [this, c = asio::coroutine{}](
+                auto&& self, boost::system::error_code ec = {}) mutable
+            {
+                BOOST_ASIO_CORO_REENTER(c)
+                for(;;)
+                {
+                    self.reset_cancellation_state(
+                        asio::enable_total_cancellation());
+
+                    timer_.expires_at(
+                        queue_.empty()
+                            ? asio::steady_timer::time_point::max()
+                            : std::max(queue_.begin()->first, not_before_));
+
+                    BOOST_ASIO_CORO_YIELD
+                    timer_.async_wait(std::move(self));
+
+                    if(!!self.cancelled())
+                        return self.complete(asio::error::operation_aborted);
+
+                    // operation_aborted without cancellation means an earlier
+                    // retry has been queued and the expiry needs an update
+                    if(ec == asio::error::operation_aborted)
+                        continue;
+
+                    release_due();
+                }
+            },
+            token,
+            timer_);
+}
+} // namespace smpp
@@ -7,11 +7,14 @@
 #include <smpp/common/request_pdu.hpp>
 #include <smpp/common/response_pdu.hpp>
 #include <smpp/common/serialization.hpp>
+#include <smpp/net/delivery_tracker.hpp>
 #include <smpp/net/detail/header_serialization.hpp>
 #include <smpp/net/detail/static_flat_buffer.hpp>
 #include <smpp/net/error.hpp>
+#include <smpp/net/pdu_template.hpp>
 #include <smpp/net/pdu_variant.hpp>
 #include <smpp/net/session.hpp>
+#include <smpp/net/shared_frame.hpp>
 
 #include <boost/asio/cancel_after.hpp>
 #include <boost/asio/compose.hpp>
@@ -20,6 +23,17 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/write.hpp>
 
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
 namespace smpp
 {
 namespace asio = boost::asio;
@@ -32,6 +46,12 @@ class session
     asio::steady_timer send_cv_;
     std::chrono::seconds enquire_link_interval_{};
     uint32_t sequence_number_{};
+    struct pending_response;
+    std::map<uint32_t, pending_response*> pending_responses_;
+    std::chrono::steady_clock::time_point enquire_link_sent_{};
+    std::chrono::steady_clock::duration enquire_link_rtt_{};
+    delivery_tracker* delivery_tracker_{};
+    std::size_t raw_pdu_length_{}; // consumed when the next receive starts
 
 public:
     /// Construct a session from a TCP socket
@@ -48,6 +68,10 @@ public:
         std::chrono::seconds enquire_link_interval = std::chrono::seconds{
             60 });
 
+    /// Return the executor of the session
+    asio::any_io_executor
+    get_executor() noexcept;
+
     /// Return a reference to the next layer
     asio::ip::tcp::socket&
     next_layer() noexcept;
@@ -56,6 +80,25 @@ public:
     const asio::ip::tcp::socket&
     next_layer() const noexcept;
 
+    /// Return the round trip time of the last enquire_link operation
+    /**
+     * The session sends enquire_link requests after a period of inactivity,
+     * the time between sending the last one and receiving its response is
+     * returned. Returns zero if no enquire_link_resp has been received yet.
+     */
+    std::chrono::steady_clock::duration
+    enquire_link_rtt() const noexcept;
+
+    /// Attach a delivery_tracker to the session
+    /**
+     * The delivery receipts that async_receive receives are passed to the
+     * tracker before async_receive completes with them, so the application
+     * still responds to them. The tracker should outlive the session, a null
+     * pointer detaches it.
+     */
+    void
+    set_delivery_tracker(delivery_tracker* tracker) noexcept;
+
     /// Start an asynchronous send for request PDUs
     /**
      * This function is used to asynchronously send a request PDU over the
@@ -86,6 +129,121 @@ public:
         const request_pdu auto& pdu,
         CompletionToken&& token = asio::deferred_t{});
 
+    /// Start an asynchronous send for request PDUs with a large payload
+    /**
+     * This function is used to asynchronously send a request PDU with a
+     * message_payload optional parameter that is referenced, instead of
+     * copied, over the session. It is an initiating function for an
+     * asynchronous_operation, and always returns immediately.
+     *
+     * The PDU and the header of the optional parameter are serialized, and the
+     * payload is written directly from the caller's memory through a gather
+     * write, so a large data_sm or submit_sm payload isn't copied into the
+     * send buffer. The memory should remain valid until the operation
+     * completes.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, uint32_t) @endcode
+     * If the serialization of a PDU fails, the PDU already has a
+     * message_payload or the payload is longer than 65535 octets, operation
+     * completes with smpp::error::serialization_failed. The
+     * boost::system::error_code can contains network errors and cancellation
+     * error. uint32_t contains sequence_number and can be used to map the
+     * response on arrival.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu The request PDU
+     * @param message_payload The value of the message_payload optional
+     * parameter
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the send completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_send(
+        const request_pdu auto& pdu,
+        asio::const_buffer message_payload,
+        CompletionToken&& token = asio::deferred_t{})
+        requires requires { pdu.oparam; };
+
+    /// Start an asynchronous send for a pdu_template
+    /**
+     * This function is used to asynchronously send a request PDU that is built
+     * from a pdu_template, with the given dest_addr and short_message, over
+     * the session. It is an initiating function for an asynchronous_operation,
+     * and always returns immediately.
+     *
+     * The template, dest_addr and short_message should remain valid until the
+     * operation completes.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, uint32_t) @endcode
+     * If dest_addr or short_message exceed their limits, operation completes
+     * with smpp::error::serialization_failed. The boost::system::error_code
+     * can contains network errors and cancellation error. uint32_t contains
+     * sequence_number and can be used to map the response on arrival.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu_template The template of the request PDU
+     * @param dest_addr The dest_addr of the request PDU
+     * @param short_message The short_message of the request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the send completes
+     */
+    template<
+        typename PDU,
+        asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_send(
+        const pdu_template<PDU>& pdu_template,
+        std::string_view dest_addr,
+        std::string_view short_message,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous send for a shared_frame
+    /**
+     * This function is used to asynchronously send a request PDU that has
+     * been serialized into a shared_frame over the session. It is an
+     * initiating function for an asynchronous_operation, and always returns
+     * immediately.
+     *
+     * Only the header is serialized, the body is written directly from the
+     * buffer of the shared_frame, which the operation keeps alive.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, uint32_t) @endcode
+     * The boost::system::error_code can contains network errors and
+     * cancellation error. uint32_t contains sequence_number and can be used to
+     * map the response on arrival.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param frame The shared_frame of the request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the send completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_send(
+        shared_frame frame,
+        CompletionToken&& token = asio::deferred_t{});
+
     /// Start an asynchronous send for response PDUs
     /**
      * This function is used to asynchronously send a response PDU over the
@@ -145,6 +303,155 @@ public:
     auto
     async_send_unbind(CompletionToken&& token = asio::deferred_t{});
 
+    /// Start an asynchronous request and wait for its response
+    /**
+     * This function is used to asynchronously send a request PDU over the
+     * session and wait for the response with the same sequence_number. It is an
+     * initiating function for an asynchronous_operation, and always returns
+     * immediately.
+     *
+     * The response is delivered by the active async_receive operation, which
+     * hands it over to this operation instead of completing with it, so there
+     * should be an ongoing async_receive operation on the session.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, pdu_variant, command_status)
+     * @endcode
+     * If the serialization of a PDU fails, operation completes with
+     * smpp::error::serialization_failed. If async_receive completes with an
+     * error while the response is pending, including
+     * asio::error::operation_aborted when it is cancelled, operation completes
+     * with the same error. The boost::system::error_code can contains network
+     * errors and cancellation error.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * A response that arrives after the operation has been cancelled would be
+     * returned by async_receive.
+     *
+     * @param pdu The request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the response arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous request and wait for its response with a timeout
+    /**
+     * This function is used like async_request, except that the operation
+     * completes with smpp::error::response_timeout if the response does not
+     * arrive within response_timeout. The timeout starts after the request
+     * has been sent and only applies to the response wait, so it never aborts
+     * a write in the middle of a frame, which would desynchronize the
+     * session.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, pdu_variant, command_status)
+     * @endcode
+     * If the response does not arrive in time, operation completes with
+     * smpp::error::response_timeout, and a response that arrives later would
+     * be returned by async_receive. Other errors are the same as
+     * async_request.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu The request PDU
+     * @param response_timeout The time to wait for the response
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the response arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        std::chrono::steady_clock::duration response_timeout,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous send of a range of request PDUs
+    /**
+     * This function is used to asynchronously send the request PDUs of a range
+     * over the session, keeping up to window requests outstanding. It is an
+     * initiating function for an asynchronous_operation, and always returns
+     * immediately.
+     *
+     * As many PDUs as the window allows are serialized back to back and sent
+     * with a single write, and the responses are handed over to the operation
+     * by the active async_receive operation, like async_request, so there
+     * should be an ongoing async_receive operation on the session. When the
+     * window is full the operation waits for any outstanding request to be
+     * answered or to time out. The state of the outstanding requests is
+     * allocated once, for the window.
+     *
+     * The response_handler is called with the index of the PDU in the range,
+     * an error, the response and its command_status, for each PDU. The error
+     * is smpp::error::serialization_failed for a PDU that fails to serialize,
+     * which is skipped, smpp::error::response_timeout for a request that is
+     * not answered in time, or the error of async_receive if it fails while
+     * the response is pending.
+     *
+     * The range should remain valid until the operation completes.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, std::size_t) @endcode
+     * The boost::system::error_code can contains network errors and
+     * cancellation error. std::size_t contains the number of PDUs that have
+     * been sent.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * Responses that arrive after the operation has been cancelled would be
+     * returned by async_receive.
+     *
+     * @param range An input range, or a generator, of request PDUs
+     * @param window The maximum number of outstanding requests, a window of
+     * zero is treated as one
+     * @param response_timeout The time to wait for the response of each
+     * request
+     * @param response_handler The handler that is called for each response
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when all the responses have
+     * arrived
+     */
+    template<
+        std::ranges::input_range Range,
+        typename ResponseHandler,
+        asio::completion_token_for<
+            void(boost::system::error_code, std::size_t)> CompletionToken =
+            asio::deferred_t>
+        requires request_pdu<
+                     std::remove_cvref_t<std::ranges::range_reference_t<Range>>>
+        && std::invocable<
+                     ResponseHandler&,
+                     std::size_t,
+                     boost::system::error_code,
+                     pdu_variant,
+                     command_status>
+    auto
+    async_send_range(
+        Range&& range,
+        std::size_t window,
+        std::chrono::steady_clock::duration response_timeout,
+        ResponseHandler response_handler,
+        CompletionToken&& token = asio::deferred_t{});
+
     /// Start an asynchronous receive
     /**
      * This function is used to asynchronously receive a PDU.
@@ -179,6 +486,117 @@ public:
     auto
     async_receive(CompletionToken&& token = asio::deferred_t{});
 
+    /// Start an asynchronous receive without deserialization
+    /**
+     * This function is used to asynchronously receive a PDU without
+     * deserializing its body, for components that only route or relay PDUs.
+     * It is an initiating function for an asynchronous_operation, and always
+     * returns immediately.
+     *
+     * enquire_link, unbind and responses to pending async_request operations
+     * are handled like async_receive does, but the PDUs aren't passed to the
+     * delivery_tracker. The body is a view into the receive buffer of the
+     * session, which remains valid until the next receive operation starts.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, command_id,
+     * std::span<const uint8_t>, uint32_t, command_status) @endcode
+     * The std::span<const uint8_t> contains the body of the PDU, everything
+     * after the header. Upon a graceful unbind, operation completes with
+     * smpp::error::unbinded. Upon an enquire_link timeout, operation completes
+     * with smpp::error::enquire_link_timeout. The boost::system::error_code can
+     * contains network errors and cancellation error.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     * @li cancellation_type::partial
+     * @li cancellation_type::total
+     *
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the receive completes
+     */
+    template<
+        asio::completion_token_for<void(
+            boost::system::error_code,
+            command_id,
+            std::span<const uint8_t>,
+            uint32_t,
+            command_status)> CompletionToken = asio::deferred_t>
+    auto
+    async_receive_raw(CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous send for an encoded request body
+    /**
+     * This function is used to asynchronously send a request PDU whose body,
+     * everything after the header, is already encoded, over the session. It
+     * is an initiating function for an asynchronous_operation, and always
+     * returns immediately.
+     *
+     * The body is written directly from the given memory, which should remain
+     * valid until the operation completes, so it can be a body that
+     * async_receive_raw has received on another session.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, uint32_t) @endcode
+     * The boost::system::error_code can contains network errors and
+     * cancellation error. uint32_t contains sequence_number and can be used to
+     * map the response on arrival.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param command_id The command_id of the request PDU
+     * @param body The encoded body of the request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the send completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_send_raw(
+        command_id command_id,
+        asio::const_buffer body,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous send for an encoded response body
+    /**
+     * This function is used to asynchronously send a response PDU whose body,
+     * everything after the header, is already encoded, over the session. It
+     * is an initiating function for an asynchronous_operation, and always
+     * returns immediately.
+     *
+     * The body is written directly from the given memory, which should remain
+     * valid until the operation completes.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code) @endcode
+     * The boost::system::error_code can contains network errors and
+     * cancellation error.
+     *
+     * @param command_id The command_id of the response PDU
+     * @param body The encoded body of the response PDU
+     * @param sequence_number The sequence_number of the request that this
+     * response belongs to
+     * @param command_status The status of the response
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the send completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_send_raw(
+        command_id command_id,
+        asio::const_buffer body,
+        uint32_t sequence_number,
+        command_status command_status,
+        CompletionToken&& token = asio::deferred_t{});
+
 private:
     uint32_t
     next_sequence_number();
@@ -186,6 +604,9 @@ private:
     void
     shutdown_socket();
 
+    void
+    fail_pending_responses(boost::system::error_code ec);
+
     auto
     async_send_command(
         command_id command_id,
@@ -193,9 +614,32 @@ private:
         asio::completion_token_for<void(boost::system::error_code)> auto&&
             token);
 
+    // sends a frame of a header, the octets that fill appends to send_buf_
+    // and a body that is not copied, the next sequence_number is used if
+    // there isn't one
+    auto
+    async_send_frame(
+        command_id command_id,
+        std::invocable<std::vector<uint8_t>*> auto fill,
+        asio::const_buffer body,
+        std::optional<uint32_t> sequence_number,
+        command_status command_status,
+        asio::completion_token_for<
+            void(boost::system::error_code, uint32_t)> auto&& token);
+
+    template<bool Raw>
     class receive_op;
 };
 
+struct session::pending_response
+{
+    asio::steady_timer* cv; // cancelled when done, it might be shared
+    boost::system::error_code ec{};
+    pdu_variant pdu{};
+    smpp::command_status command_status{};
+    bool done{ false };
+};
+
 inline session::session(
     asio::ip::tcp::socket socket,
     std::chrono::seconds enquire_link_interval)
@@ -205,6 +649,12 @@ inline session::session(
 {
 }
 
+inline asio::any_io_executor
+session::get_executor() noexcept
+{
+    return socket_.get_executor();
+}
+
 inline asio::ip::tcp::socket&
 session::next_layer() noexcept
 {
@@ -217,6 +667,18 @@ session::next_layer() const noexcept
     return socket_;
 }
 
+inline std::chrono::steady_clock::duration
+session::enquire_link_rtt() const noexcept
+{
+    return enquire_link_rtt_;
+}
+
+inline void
+session::set_delivery_tracker(delivery_tracker* tracker) noexcept
+{
+    delivery_tracker_ = tracker;
+}
+
 inline uint32_t
 session::next_sequence_number()
 {
@@ -233,6 +695,18 @@ session::shutdown_socket()
     socket_.close(ec);
 }
 
+inline void
+session::fail_pending_responses(boost::system::error_code ec)
+{
+    for(auto& [sequence_number, pending] : pending_responses_)
+    {
+        pending->ec   = ec;
+        pending->done = true;
+        pending->cv->cancel();
+    }
+    pending_responses_.clear();
+}
+
 auto
 session::async_send_command(
     command_id command_id,
@@ -290,6 +764,84 @@ session::async_send_command(
             socket_);
 }
 
+auto
+session::async_send_frame(
+    command_id command_id,
+    std::invocable<std::vector<uint8_t>*> auto fill,
+    asio::const_buffer body,
+    std::optional<uint32_t> sequence_number,
+    command_status command_status,
+    asio::completion_token_for<void(boost::system::error_code, uint32_t)> auto&&
+        token)
+{
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, uint32_t)>(
+        [this,
+         command_id,
+         fill = std::move(fill),
+         body,
+         sequence_number,
+         command_status,
+         c = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec = {},
+            std::size_t                  = {}) mutable
+        {
+            BOOST_ASIO_CORO_REENTER(c)
+            {
+                self.reset_cancellation_state(
+                    asio::enable_total_cancellation());
+
+                while(!send_buf_.empty()) // ongoing send operation
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    send_cv_.async_wait(std::move(self));
+                    if(ec != asio::error::operation_aborted ||
+                       !!self.cancelled())
+                        return self.complete(ec, {});
+                }
+
+                send_buf_.resize(header_length); // reserved for header
+                try
+                {
+                    fill(&send_buf_);
+                }
+                catch(const std::exception&)
+                {
+                    send_buf_.clear();
+                    return self.complete(error::serialization_failed, {});
+                }
+
+                if(!sequence_number)
+                    sequence_number = next_sequence_number();
+
+                detail::serialize_header(
+                    std::span<uint8_t, header_length>{ send_buf_ },
+                    send_buf_.size() + body.size(),
+                    command_id,
+                    *sequence_number,
+                    command_status);
+
+                self.reset_cancellation_state(
+                    asio::enable_terminal_cancellation());
+
+                BOOST_ASIO_CORO_YIELD
+                asio::async_write(
+                    socket_,
+                    std::array<asio::const_buffer, 2>{
+                        asio::buffer(send_buf_), body },
+                    std::move(self));
+
+                send_buf_.clear();
+                send_cv_.cancel_one();
+                self.complete(ec, *sequence_number);
+            }
+        },
+        token,
+        socket_);
+}
+
 template<asio::completion_token_for<void(boost::system::error_code, uint32_t)>
              CompletionToken>
 auto
@@ -350,6 +902,92 @@ session::async_send(const request_pdu auto& pdu, CompletionToken&& token)
         socket_);
 }
 
+template<asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+             CompletionToken>
+auto
+session::async_send(
+    const request_pdu auto& pdu,
+    asio::const_buffer message_payload,
+    CompletionToken&& token)
+    requires requires { pdu.oparam; }
+{
+    // the PDU and the tag and length of message_payload are serialized, its
+    // value is not copied
+    auto fill = [&pdu, size = message_payload.size()](std::vector<uint8_t>* buf)
+    {
+        if(size > 65535 || pdu.oparam.contains(oparam_tag::message_payload))
+            throw std::length_error{ "message_payload is invalid" };
+
+        serialize_to(buf, pdu);
+        for(auto val : { static_cast<uint16_t>(oparam_tag::message_payload),
+                         static_cast<uint16_t>(size) })
+        {
+            buf->push_back((val >> 8) & 0xFF);
+            buf->push_back((val >> 0) & 0xFF);
+        }
+    };
+
+    return async_send_frame(
+        std::decay_t<decltype(pdu)>::command_id,
+        std::move(fill),
+        message_payload,
+        std::nullopt,
+        command_status::rok,
+        std::forward<CompletionToken>(token));
+}
+
+template<
+    typename PDU,
+    asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+        CompletionToken>
+auto
+session::async_send(
+    const pdu_template<PDU>& pdu_template,
+    std::string_view dest_addr,
+    std::string_view short_message,
+    CompletionToken&& token)
+{
+    return async_send_frame(
+        PDU::command_id,
+        [&pdu_template, dest_addr, short_message](std::vector<uint8_t>* buf)
+        { pdu_template.build_body(buf, dest_addr, short_message); },
+        {},
+        std::nullopt,
+        command_status::rok,
+        std::forward<CompletionToken>(token));
+}
+
+template<asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+             CompletionToken>
+auto
+session::async_send(shared_frame frame, CompletionToken&& token)
+{
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, uint32_t)>(
+        [this, frame = std::move(frame), c = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec = {},
+            uint32_t sequence_number     = {}) mutable
+        {
+            BOOST_ASIO_CORO_REENTER(c)
+            {
+                // the frame is kept alive by this operation
+                BOOST_ASIO_CORO_YIELD
+                async_send_frame(
+                    frame.command_id(),
+                    [](std::vector<uint8_t>*) {},
+                    asio::buffer(frame.body().data(), frame.body().size()),
+                    std::nullopt,
+                    command_status::rok,
+                    std::move(self));
+                self.complete(ec, sequence_number);
+            }
+        },
+        token,
+        socket_);
+}
+
 template<
     asio::completion_token_for<void(boost::system::error_code)> CompletionToken>
 auto
@@ -425,6 +1063,336 @@ session::async_send_unbind(CompletionToken&& token)
         std::forward<decltype(token)>(token));
 }
 
+template<asio::completion_token_for<
+    void(boost::system::error_code, pdu_variant, command_status)>
+             CompletionToken>
+auto
+session::async_request(const request_pdu auto& pdu, CompletionToken&& token)
+{
+    return async_request(
+        pdu,
+        std::chrono::steady_clock::duration::max(),
+        std::forward<CompletionToken>(token));
+}
+
+template<asio::completion_token_for<
+    void(boost::system::error_code, pdu_variant, command_status)>
+             CompletionToken>
+auto
+session::async_request(
+    const request_pdu auto& pdu,
+    std::chrono::steady_clock::duration response_timeout,
+    CompletionToken&& token)
+{
+    struct request_state
+    {
+        asio::steady_timer cv;
+        pending_response pending{ &cv };
+
+        explicit request_state(const asio::any_io_executor& executor)
+            : cv{ executor, asio::steady_timer::time_point::max() }
+        {
+        }
+    };
+
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, pdu_variant, command_status)>(
+        [this,
+         &pdu,
+         response_timeout,
+         state           = std::unique_ptr<request_state>{},
+         sequence_number = uint32_t{},
+         c               = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec = {},
+            uint32_t                     = {}) mutable
+        {
+            BOOST_ASIO_CORO_REENTER(c)
+            {
+                // registered before the write, like async_send_range, so the
+                // response is handed over even if it is read before the write
+                // operation completes
+                sequence_number = next_sequence_number();
+                state = std::make_unique<request_state>(socket_.get_executor());
+                pending_responses_.emplace(sequence_number, &state->pending);
+
+                BOOST_ASIO_CORO_YIELD
+                async_send_frame(
+                    std::decay_t<decltype(pdu)>::command_id,
+                    [&pdu](std::vector<uint8_t>* buf)
+                    { serialize_to(buf, pdu); },
+                    {},
+                    sequence_number,
+                    command_status::rok,
+                    std::move(self));
+                if(ec)
+                {
+                    pending_responses_.erase(sequence_number);
+                    return self.complete(ec, {}, {});
+                }
+
+                // the timeout starts once the request has been sent
+                using duration = std::chrono::steady_clock::duration;
+                if(response_timeout != duration::max())
+                    state->cv.expires_after(response_timeout);
+
+                while(!state->pending.done)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    state->cv.async_wait(std::move(self));
+                    if(!state->pending.done && !ec)
+                    {
+                        pending_responses_.erase(sequence_number);
+                        return self.complete(error::response_timeout, {}, {});
+                    }
+                    if(!state->pending.done &&
+                       (ec != asio::error::operation_aborted ||
+                        !!self.cancelled()))
+                    {
+                        pending_responses_.erase(sequence_number);
+                        return self.complete(
+                            ec ? ec : asio::error::operation_aborted, {}, {});
+                    }
+                }
+
+                self.complete(
+                    state->pending.ec,
+                    std::move(state->pending.pdu),
+                    state->pending.command_status);
+            }
+        },
+        token,
+        socket_);
+}
+
+template<
+    std::ranges::input_range Range,
+    typename ResponseHandler,
+    asio::completion_token_for<void(boost::system::error_code, std::size_t)>
+        CompletionToken>
+    requires request_pdu<
+                 std::remove_cvref_t<std::ranges::range_reference_t<Range>>>
+    && std::invocable<
+                 ResponseHandler&,
+                 std::size_t,
+                 boost::system::error_code,
+                 pdu_variant,
+                 command_status>
+auto
+session::async_send_range(
+    Range&& range,
+    std::size_t window,
+    std::chrono::steady_clock::duration response_timeout,
+    ResponseHandler response_handler,
+    CompletionToken&& token)
+{
+    using pdu_type =
+        std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+    using clock = std::chrono::steady_clock;
+
+    // stop adding PDUs to a write once it has this many octets
+    static constexpr std::size_t max_write_size{ 64 * 1024 };
+
+    struct outstanding
+    {
+        std::size_t index;
+        uint32_t sequence_number;
+        clock::time_point deadline;
+        pending_response response;
+    };
+
+    // allocated once, the slots are reused and all of them share cv, which
+    // wakes the operation up on any response
+    struct range_state
+    {
+        asio::steady_timer cv;
+        std::vector<outstanding> slots;
+        std::vector<std::size_t> free; // indices of the free slots
+
+        range_state(const asio::any_io_executor& executor, std::size_t window)
+            : cv{ executor }
+        {
+            slots.reserve(window);
+            free.reserve(window);
+            for(auto i = window; i-- != 0;)
+            {
+                slots.push_back({ 0, 0, {}, pending_response{ &cv } });
+                free.push_back(i);
+            }
+        }
+
+        std::size_t
+        outstandings() const noexcept
+        {
+            return slots.size() - free.size();
+        }
+    };
+
+    window = std::max<std::size_t>(window, 1);
+
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, std::size_t)>(
+        [this,
+         it               = std::ranges::begin(range),
+         end              = std::ranges::end(range),
+         response_timeout,
+         response_handler = std::move(response_handler),
+         state = std::make_unique<range_state>(socket_.get_executor(), window),
+         index = std::size_t{},
+         sent  = std::size_t{},
+         batch = std::size_t{},
+         c     = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec = {},
+            std::size_t                  = {}) mutable
+        {
+            // reports the arrived and the timed out responses, and returns
+            // the earliest deadline of the others
+            auto report = [&]
+            {
+                const auto now = clock::now();
+                auto earliest  = clock::time_point::max();
+                for(auto i = std::size_t{}; i < state->slots.size(); i++)
+                {
+                    auto& o = state->slots[i];
+                    if(o.sequence_number == 0)
+                        continue;
+
+                    if(!o.response.done)
+                    {
+                        if(o.deadline > now)
+                        {
+                            earliest = std::min(earliest, o.deadline);
+                            continue;
+                        }
+                        pending_responses_.erase(o.sequence_number);
+                        o.response.ec = error::response_timeout;
+                    }
+
+                    response_handler(
+                        o.index,
+                        o.response.ec,
+                        std::move(o.response.pdu),
+                        o.response.command_status);
+                    o.sequence_number = 0;
+                    o.response        = pending_response{ &state->cv };
+                    state->free.push_back(i);
+                }
+                return earliest;
+            };
+
+            auto complete = [&](boost::system::error_code error)
+            {
+                for(const auto& o : state->slots)
+                    if(o.sequence_number != 0 && !o.response.done)
+                        pending_responses_.erase(o.sequence_number);
+                self.complete(error, sent);
+            };
+
+            BOOST_ASIO_CORO_REENTER(c)
+            {
+                while(it != end || state->outstandings() != 0)
+                {
+                    state->cv.expires_at(report());
+
+                    if(it != end && !state->free.empty())
+                    {
+                        self.reset_cancellation_state(
+                            asio::enable_total_cancellation());
+
+                        while(!send_buf_.empty()) // ongoing send operation
+                        {
+                            BOOST_ASIO_CORO_YIELD
+                            send_cv_.async_wait(std::move(self));
+                            if(ec != asio::error::operation_aborted ||
+                               !!self.cancelled())
+                                return complete(ec);
+                        }
+
+                        batch = 0;
+                        while(it != end && !state->free.empty() &&
+                              send_buf_.size() < max_write_size)
+                        {
+                            const auto begin = send_buf_.size();
+                            send_buf_.resize(begin + header_length);
+                            try
+                            {
+                                serialize_to(&send_buf_, *it);
+                            }
+                            catch(const std::exception&)
+                            {
+                                send_buf_.resize(begin);
+                                response_handler(
+                                    index++,
+                                    error::serialization_failed,
+                                    pdu_variant{},
+                                    command_status{});
+                                ++it;
+                                continue;
+                            }
+
+                            const auto sequence_number = next_sequence_number();
+                            detail::serialize_header(
+                                std::span<uint8_t, header_length>{
+                                    send_buf_.data() + begin, header_length },
+                                send_buf_.size() - begin,
+                                pdu_type::command_id,
+                                sequence_number);
+
+                            auto& o = state->slots[state->free.back()];
+                            state->free.pop_back();
+                            o.index           = index++;
+                            o.sequence_number = sequence_number;
+                            o.deadline = clock::now() + response_timeout;
+                            pending_responses_.emplace(
+                                sequence_number, &o.response);
+                            ++it;
+                            batch++;
+                        }
+
+                        if(send_buf_.empty()) // all of them failed
+                        {
+                            send_cv_.cancel_one();
+                            continue;
+                        }
+
+                        self.reset_cancellation_state(
+                            asio::enable_terminal_cancellation());
+
+                        BOOST_ASIO_CORO_YIELD
+                        asio::async_write(
+                            socket_, asio::buffer(send_buf_), std::move(self));
+
+                        send_buf_.clear();
+                        send_cv_.cancel_one();
+                        if(ec)
+                            return complete(ec);
+                        sent += batch;
+                        continue;
+                    }
+
+                    self.reset_cancellation_state(
+                        asio::enable_terminal_cancellation());
+
+                    // until any response arrives or the earliest deadline
+                    BOOST_ASIO_CORO_YIELD
+                    state->cv.async_wait(std::move(self));
+                    if(!!self.cancelled())
+                        return complete(asio::error::operation_aborted);
+                    if(ec && ec != asio::error::operation_aborted)
+                        return complete(ec);
+                }
+
+                complete({});
+            }
+        },
+        token,
+        socket_);
+}
+
+template<bool Raw>
 class session::receive_op
 {
     session* s_;
@@ -454,6 +1422,12 @@ public:
         {
             using enum smpp::command_id;
 
+            if(s_->raw_pdu_length_ != 0) // left by async_receive_raw
+            {
+                s_->receive_buf_.consume(s_->raw_pdu_length_);
+                s_->raw_pdu_length_ = 0;
+            }
+
             if(needs_more_)
             {
                 needs_more_ = false;
@@ -487,10 +1461,13 @@ public:
                             s_->next_sequence_number(),
                             std::move(self));
                         s_->shutdown_socket();
-                        return self.complete(
-                            error::enquire_link_timeout, {}, {}, {});
+                        s_->fail_pending_responses(
+                            error::enquire_link_timeout);
+                        return complete_with_error(
+                            self, error::enquire_link_timeout);
                     }
-                    pending_enquire_link_ = true;
+                    pending_enquire_link_  = true;
+                    s_->enquire_link_sent_ = std::chrono::steady_clock::now();
                     BOOST_ASIO_CORO_YIELD
                     s_->async_send_command(
                         enquire_link,
@@ -499,7 +1476,13 @@ public:
                 }
 
                 if(ec)
-                    return self.complete(ec, {}, {}, {});
+                {
+                    // nothing hands the responses over until the next
+                    // async_receive, so pending requests fail with ec, which
+                    // is operation_aborted on cancellation
+                    s_->fail_pending_responses(ec);
+                    return complete_with_error(self, ec);
+                }
             }
 
             if(s_->receive_buf_.size() < header_length)
@@ -532,6 +1515,10 @@ public:
             }
             else if(command_id_ == enquire_link_resp)
             {
+                if(s_->enquire_link_sent_ !=
+                   std::chrono::steady_clock::time_point{})
+                    s_->enquire_link_rtt_ = std::chrono::steady_clock::now() -
+                        s_->enquire_link_sent_;
                 s_->receive_buf_.consume(command_length_);
             }
             else if(command_id_ == unbind || command_id_ == unbind_resp)
@@ -542,11 +1529,15 @@ public:
                     s_->async_send_command(
                         unbind_resp, sequence_number_, std::move(self));
                     if(ec)
-                        return self.complete(ec, {}, {}, {});
+                    {
+                        s_->fail_pending_responses(ec);
+                        return complete_with_error(self, ec);
+                    }
                 }
                 s_->shutdown_socket();
                 s_->receive_buf_.consume(command_length_);
-                return self.complete(error::unbinded, {}, {}, {});
+                s_->fail_pending_responses(error::unbinded);
+                return complete_with_error(self, error::unbinded);
             }
             else
             {
@@ -559,6 +1550,23 @@ public:
                 auto body_buf =
                     std::span{ s_->receive_buf_.begin() + header_length,
                                s_->receive_buf_.begin() + command_length_ };
+
+                if constexpr(Raw)
+                {
+                    // responses of async_request are still deserialized
+                    if(!is_response(command_id_) ||
+                       !s_->pending_responses_.contains(sequence_number_))
+                    {
+                        s_->raw_pdu_length_ = command_length_;
+                        return self.complete(
+                            {},
+                            command_id_,
+                            body_buf,
+                            sequence_number_,
+                            command_status_);
+                    }
+                }
+
                 auto pdu = pdu_variant{};
                 try
                 {
@@ -586,11 +1594,53 @@ public:
                                        e.what() };
                 }
                 s_->receive_buf_.consume(command_length_);
-                return self.complete(
-                    {}, std::move(pdu), sequence_number_, command_status_);
+
+                if(is_response(command_id_))
+                {
+                    auto it = s_->pending_responses_.find(sequence_number_);
+                    if(it != s_->pending_responses_.end())
+                    {
+                        it->second->pdu            = std::move(pdu);
+                        it->second->command_status = command_status_;
+                        it->second->done           = true;
+                        it->second->cv->cancel();
+                        s_->pending_responses_.erase(it);
+                        continue;
+                    }
+                }
+
+                if constexpr(!Raw)
+                {
+                    if(s_->delivery_tracker_)
+                    {
+                        std::visit(
+                            [&]<typename Pdu>(const Pdu& p)
+                            {
+                                if constexpr(
+                                    std::is_same_v<Pdu, smpp::deliver_sm> ||
+                                    std::is_same_v<Pdu, smpp::data_sm>)
+                                    s_->delivery_tracker_->on_delivery_receipt(
+                                        p);
+                            },
+                            pdu);
+                    }
+
+                    return self.complete(
+                        {}, std::move(pdu), sequence_number_, command_status_);
+                }
             }
         }
     }
+
+private:
+    static void
+    complete_with_error(auto& self, boost::system::error_code ec)
+    {
+        if constexpr(Raw)
+            self.complete(ec, {}, {}, {}, {});
+        else
+            self.complete(ec, {}, {}, {});
+    }
 };
 
 template<asio::completion_token_for<
@@ -602,6 +1652,81 @@ session::async_receive(CompletionToken&& token)
     return asio::async_compose<
         decltype(token),
         void(boost::system::error_code, pdu_variant, uint32_t, command_status)>(
-        receive_op{ this }, token, socket_);
+        receive_op<false>{ this }, token, socket_);
+}
+
+template<asio::completion_token_for<void(
+    boost::system::error_code,
+    command_id,
+    std::span<const uint8_t>,
+    uint32_t,
+    command_status)> CompletionToken>
+auto
+session::async_receive_raw(CompletionToken&& token)
+{
+    return asio::async_compose<
+        decltype(token),
+        void(
+            boost::system::error_code,
+            command_id,
+            std::span<const uint8_t>,
+            uint32_t,
+            command_status)>(receive_op<true>{ this }, token, socket_);
+}
+
+template<asio::completion_token_for<void(boost::system::error_code, uint32_t)>
+             CompletionToken>
+auto
+session::async_send_raw(
+    command_id command_id,
+    asio::const_buffer body,
+    CompletionToken&& token)
+{
+    return async_send_frame(
+        command_id,
+        [](std::vector<uint8_t>*) {},
+        body,
+        std::nullopt,
+        command_status::rok,
+        std::forward<CompletionToken>(token));
+}
+
+template<
+    asio::completion_token_for<void(boost::system::error_code)> CompletionToken>
+auto
+session::async_send_raw(
+    command_id command_id,
+    asio::const_buffer body,
+    uint32_t sequence_number,
+    command_status command_status,
+    CompletionToken&& token)
+{
+    return asio::
+        async_compose<decltype(token), void(boost::system::error_code)>(
+            [this,
+             command_id,
+             body,
+             sequence_number,
+             command_status,
+             c = asio::coroutine{}](
+                auto&& self,
+                boost::system::error_code ec = {},
+                uint32_t                     = {}) mutable
+            {
+                BOOST_ASIO_CORO_REENTER(c)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    async_send_frame(
+                        command_id,
+                        [](std::vector<uint8_t>*) {},
+                        body,
+                        sequence_number,
+                        command_status,
+                        std::move(self));
+                    self.complete(ec);
+                }
+            },
+            token,
+            socket_);
 }
 } // namespace smpp
@@ -0,0 +1,701 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/net/retry_policy.hpp>
+#include <smpp/net/session.hpp>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/cancel_after.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <variant>
+#include <vector>
+
+namespace smpp
+{
+namespace asio = boost::asio;
+
+enum class load_balancing
+{
+    least_outstanding, // ties are broken by the lowest latency
+    lowest_latency     // ties are broken by the least outstanding requests
+};
+
+class session_pool
+{
+public:
+    using bind_pdu =
+        std::variant<bind_transmitter, bind_receiver, bind_transceiver>;
+
+    using inbound_handler = std::function<
+        void(std::shared_ptr<session>, pdu_variant, uint32_t, command_status)>;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct member
+    {
+        std::shared_ptr<smpp::session> session;
+        std::size_t outstanding{};
+        clock::duration latency{};
+        bool bound{ false };
+    };
+
+    asio::any_io_executor executor_;
+    asio::ip::tcp::endpoint endpoint_;
+    bind_pdu bind_pdu_;
+    std::chrono::seconds enquire_link_interval_;
+    std::vector<std::shared_ptr<member>> members_;
+    std::vector<asio::steady_timer> reconnect_timers_;
+    retry_policy reconnect_policy_{
+        .initial_backoff = std::chrono::seconds{ 1 },
+        .max_backoff     = std::chrono::seconds{ 30 }
+    };
+    smpp::load_balancing load_balancing_{ load_balancing::least_outstanding };
+    inbound_handler inbound_handler_;
+    delivery_tracker* delivery_tracker_{};
+    asio::steady_timer ready_cv_;
+    asio::steady_timer run_cv_;
+    std::size_t running_{};
+    bool replay_{ false };
+    bool stopping_{ false };
+    bool stopped_{ false };
+    std::minstd_rand rng_{ std::random_device{}() };
+
+public:
+    /// Construct a session_pool
+    /**
+     * This constructor creates a session_pool, sessions are opened and bound
+     * by async_run.
+     *
+     * @param executor The executor that sessions would be created on
+     * @param endpoint The endpoint of the peer
+     * @param bind_pdu The bind request that each session would be bound with
+     * @param size The number of sessions
+     * @param enquire_link_interval The interval for detecting inactivity and
+     * enquire_link operation of each session
+     */
+    session_pool(
+        asio::any_io_executor executor,
+        asio::ip::tcp::endpoint endpoint,
+        bind_pdu bind_pdu,
+        std::size_t size,
+        std::chrono::seconds enquire_link_interval = std::chrono::seconds{
+            60 });
+
+    /// Set the policy of choosing a session for each request
+    void
+    set_load_balancing(smpp::load_balancing load_balancing);
+
+    /// Set the backoff policy of replacing dead sessions
+    /**
+     * The max_attempts of the policy is ignored and reconnection attempts
+     * continue until async_run is cancelled.
+     */
+    void
+    set_reconnect_policy(retry_policy policy);
+
+    /// Set whether requests that their session fails should be replayed
+    /**
+     * When enabled, a request that its session fails before its response
+     * arrives is sent again over another bound session, with a new sequence
+     * number, and its completion handler stays attached. The peer might
+     * receive such a request twice if it has been received before the
+     * failure.
+     */
+    void
+    set_replay_on_failure(bool replay);
+
+    /// Set the handler of the inbound requests
+    /**
+     * The handler is invoked with the session that the request has been
+     * received on, which should be used for sending the response. Without a
+     * handler, inbound requests are rejected with their response PDU, like
+     * deliver_sm_resp, and smpp::command_status::rx_t_appn, so the peer can
+     * redeliver them later. alert_notification has no response and is
+     * dropped.
+     */
+    void
+    set_inbound_handler(inbound_handler handler);
+
+    /// Attach a delivery_tracker to the sessions
+    /**
+     * See session::set_delivery_tracker, it applies to the sessions that are
+     * opened afterwards.
+     */
+    void
+    set_delivery_tracker(delivery_tracker* tracker) noexcept;
+
+    /// Return the executor of the session_pool
+    asio::any_io_executor
+    get_executor() const noexcept;
+
+    /// Return the number of bound sessions
+    std::size_t
+    bound_sessions() const noexcept;
+
+    /// Return the number of requests waiting for their response
+    std::size_t
+    outstanding_requests() const noexcept;
+
+    /// Start an asynchronous request on one of the sessions
+    /**
+     * This function is used to asynchronously send a request PDU over the
+     * bound session that is selected by the load_balancing policy and wait for
+     * its response. If there is no bound session, it waits until a session is
+     * bound. It is an initiating function for an asynchronous_operation, and
+     * always returns immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code, pdu_variant, command_status)
+     * @endcode
+     * See session::async_request. If async_run completes while the operation
+     * waits for a bound session, it completes with
+     * asio::error::operation_aborted. If replay on failure is enabled, errors
+     * of the session are not reported and the request is sent again after a
+     * session is bound, while smpp::error::serialization_failed is reported.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     *
+     * @param pdu The request PDU
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the response arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous request on one of the sessions with a timeout
+    /**
+     * This function is used like async_request, except that the operation
+     * completes with smpp::error::response_timeout if no session is bound or
+     * the response does not arrive within response_timeout. The time of the
+     * response is measured by session::async_request, after the request has
+     * been sent, so the timeout never aborts a write.
+     *
+     * @param pdu The request PDU
+     * @param response_timeout The time to wait for a bound session and for
+     * the response
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the response arrives
+     */
+    template<
+        asio::completion_token_for<
+            void(boost::system::error_code, pdu_variant, command_status)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_request(
+        const request_pdu auto& pdu,
+        std::chrono::steady_clock::duration response_timeout,
+        CompletionToken&& token = asio::deferred_t{});
+
+    /// Start an asynchronous operation that runs the sessions
+    /**
+     * This function is used to open, bind and receive on each session, and to
+     * replace the sessions that fail with new ones. It is an initiating
+     * function for an asynchronous_operation, and always returns immediately.
+     *
+     * @par Completion Signature
+     * @code void(boost::system::error_code) @endcode
+     * Completes with asio::error::operation_aborted after it is cancelled and
+     * all the sessions are closed.
+     *
+     * @par Per-Operation Cancellation
+     * This asynchronous operation supports cancellation for the following
+     * asio::cancellation_type values:
+     * @li cancellation_type::terminal
+     * @li cancellation_type::partial
+     * @li cancellation_type::total
+     *
+     * @param token The completion_token that will be used to produce a
+     * completion handler, which will be called when the operation completes
+     */
+    template<
+        asio::completion_token_for<void(boost::system::error_code)>
+            CompletionToken = asio::deferred_t>
+    auto
+    async_run(CompletionToken&& token = asio::deferred_t{});
+
+private:
+    std::shared_ptr<member>
+    select_member() const;
+
+    void
+    stop_members();
+
+    static bool
+    is_response_pdu(const pdu_variant& pdu);
+
+    static bool
+    is_session_failure(boost::system::error_code ec);
+
+    class member_op;
+};
+
+inline session_pool::session_pool(
+    asio::any_io_executor executor,
+    asio::ip::tcp::endpoint endpoint,
+    bind_pdu bind_pdu,
+    std::size_t size,
+    std::chrono::seconds enquire_link_interval)
+    : executor_{ std::move(executor) }
+    , endpoint_{ std::move(endpoint) }
+    , bind_pdu_{ std::move(bind_pdu) }
+    , enquire_link_interval_{ enquire_link_interval }
+    , members_(size)
+    , ready_cv_{ executor_, asio::steady_timer::time_point::max() }
+    , run_cv_{ executor_, asio::steady_timer::time_point::max() }
+{
+    reconnect_timers_.reserve(size);
+    for(auto i = std::size_t{}; i < size; i++)
+        reconnect_timers_.emplace_back(executor_);
+}
+
+inline void
+session_pool::set_load_balancing(smpp::load_balancing load_balancing)
+{
+    load_balancing_ = load_balancing;
+}
+
+inline void
+session_pool::set_reconnect_policy(retry_policy policy)
+{
+    reconnect_policy_ = policy;
+}
+
+inline void
+session_pool::set_replay_on_failure(bool replay)
+{
+    replay_ = replay;
+}
+
+inline void
+session_pool::set_inbound_handler(inbound_handler handler)
+{
+    inbound_handler_ = std::move(handler);
+}
+
+inline void
+session_pool::set_delivery_tracker(delivery_tracker* tracker) noexcept
+{
+    delivery_tracker_ = tracker;
+}
+
+inline asio::any_io_executor
+session_pool::get_executor() const noexcept
+{
+    return executor_;
+}
+
+inline std::size_t
+session_pool::bound_sessions() const noexcept
+{
+    return static_cast<std::size_t>(std::count_if(
+        members_.begin(),
+        members_.end(),
+        [](const auto& m) { return m && m->bound; }));
+}
+
+inline std::size_t
+session_pool::outstanding_requests() const noexcept
+{
+    auto outstanding = std::size_t{};
+    for(const auto& m : members_)
+        if(m)
+            outstanding += m->outstanding;
+    return outstanding;
+}
+
+inline std::shared_ptr<session_pool::member>
+session_pool::select_member() const
+{
+    auto less = [this](const member& a, const member& b)
+    {
+        if(load_balancing_ == load_balancing::lowest_latency)
+            return std::tie(a.latency, a.outstanding) <
+                std::tie(b.latency, b.outstanding);
+        return std::tie(a.outstanding, a.latency) <
+            std::tie(b.outstanding, b.latency);
+    };
+
+    auto selected = std::shared_ptr<member>{};
+    for(const auto& m : members_)
+        if(m && m->bound && (!selected || less(*m, *selected)))
+            selected = m;
+    return selected;
+}
+
+inline void
+session_pool::stop_members()
+{
+    stopping_ = true;
+    for(auto& timer : reconnect_timers_)
+        timer.cancel();
+    for(auto& m : members_)
+    {
+        if(m)
+        {
+            auto ec = boost::system::error_code{};
+            m->session->next_layer().close(ec);
+        }
+    }
+}
+
+inline bool
+session_pool::is_response_pdu(const pdu_variant& pdu)
+{
+    return std::visit(
+        [](const auto& pdu)
+        {
+            using pdu_t = std::decay_t<decltype(pdu)>;
+            if constexpr(requires { pdu_t::command_id; })
+                return is_response(pdu_t::command_id);
+            return false;
+        },
+        pdu);
+}
+
+inline bool
+session_pool::is_session_failure(boost::system::error_code ec)
+{
+    // other errors of smpp, like serialization_failed, are of the request
+    return ec.category() != error_category() || ec == error::unbinded ||
+        ec == error::enquire_link_timeout;
+}
+
+class session_pool::member_op
+{
+    session_pool* p_;
+    std::size_t index_;
+    std::shared_ptr<member> m_{};
+    uint32_t attempt_{};
+    pdu_variant pdu_{};
+    uint32_t sequence_number_{};
+    command_status command_status_{};
+    asio::coroutine c_{};
+
+public:
+    member_op(session_pool* p, std::size_t index)
+        : p_{ p }
+        , index_{ index }
+    {
+    }
+
+    void
+    operator()(auto&& self, boost::system::error_code ec, uint32_t sent_seq)
+    {
+        sequence_number_ = sent_seq;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(
+        auto&& self,
+        boost::system::error_code ec,
+        pdu_variant pdu,
+        uint32_t sequence_number,
+        command_status command_status)
+    {
+        pdu_             = std::move(pdu);
+        sequence_number_ = sequence_number;
+        command_status_  = command_status;
+        (*this)(self, ec);
+    }
+
+    void
+    operator()(auto&& self, boost::system::error_code ec = {})
+    {
+        BOOST_ASIO_CORO_REENTER(c_)
+        for(;;)
+        {
+            if(p_->stopping_)
+                return self.complete({});
+
+            if(attempt_ != 0)
+            {
+                p_->reconnect_timers_[index_].expires_after(
+                    p_->reconnect_policy_.backoff(
+                        attempt_,
+                        std::uniform_real_distribution<>{}(p_->rng_)));
+
+                BOOST_ASIO_CORO_YIELD
+                p_->reconnect_timers_[index_].async_wait(std::move(self));
+
+                if(p_->stopping_)
+                    return self.complete({});
+            }
+
+            attempt_++;
+            m_ = std::make_shared<member>(member{ std::make_shared<session>(
+                asio::ip::tcp::socket{ p_->executor_ },
+                p_->enquire_link_interval_) });
+            m_->session->set_delivery_tracker(p_->delivery_tracker_);
+            p_->members_[index_] = m_;
+
+            BOOST_ASIO_CORO_YIELD
+            m_->session->next_layer().async_connect(
+                p_->endpoint_, std::move(self));
+            if(ec)
+                continue;
+
+            BOOST_ASIO_CORO_YIELD
+            std::visit(
+                [&](const auto& bind)
+                { m_->session->async_send(bind, std::move(self)); },
+                p_->bind_pdu_);
+            if(ec)
+                continue;
+
+            BOOST_ASIO_CORO_YIELD
+            m_->session->async_receive(std::move(self));
+            if(ec || command_status_ != command_status::rok ||
+               !(std::holds_alternative<bind_transmitter_resp>(pdu_) ||
+                 std::holds_alternative<bind_receiver_resp>(pdu_) ||
+                 std::holds_alternative<bind_transceiver_resp>(pdu_)))
+            {
+                auto ignored = boost::system::error_code{};
+                m_->session->next_layer().close(ignored);
+                continue;
+            }
+
+            attempt_   = 0;
+            m_->bound = true;
+            p_->ready_cv_.cancel();
+
+            for(;;)
+            {
+                BOOST_ASIO_CORO_YIELD
+                m_->session->async_receive(std::move(self));
+                if(ec)
+                    break;
+
+                // late responses of cancelled requests
+                if(is_response_pdu(pdu_))
+                    continue;
+
+                if(p_->inbound_handler_)
+                {
+                    p_->inbound_handler_(
+                        m_->session,
+                        std::move(pdu_),
+                        sequence_number_,
+                        command_status_);
+                    continue;
+                }
+
+                if(std::holds_alternative<alert_notification>(pdu_))
+                    continue;
+
+                BOOST_ASIO_CORO_YIELD
+                {
+                    static const auto deliver_sm_nack = deliver_sm_resp{};
+                    static const auto data_sm_nack    = data_sm_resp{};
+                    static const auto nack            = generic_nack{};
+                    if(std::holds_alternative<deliver_sm>(pdu_))
+                        m_->session->async_send(
+                            deliver_sm_nack,
+                            sequence_number_,
+                            command_status::rx_t_appn,
+                            std::move(self));
+                    else if(std::holds_alternative<data_sm>(pdu_))
+                        m_->session->async_send(
+                            data_sm_nack,
+                            sequence_number_,
+                            command_status::rx_t_appn,
+                            std::move(self));
+                    else
+                        m_->session->async_send(
+                            nack,
+                            sequence_number_,
+                            command_status::rx_t_appn,
+                            std::move(self));
+                }
+                if(ec)
+                    break;
+            }
+
+            m_->bound = false;
+        }
+    }
+};
+
+template<asio::completion_token_for<
+    void(boost::system::error_code, pdu_variant, command_status)>
+             CompletionToken>
+auto
+session_pool::async_request(
+    const request_pdu auto& pdu,
+    CompletionToken&& token)
+{
+    return async_request(
+        pdu, clock::duration::max(), std::forward<CompletionToken>(token));
+}
+
+template<asio::completion_token_for<
+    void(boost::system::error_code, pdu_variant, command_status)>
+             CompletionToken>
+auto
+session_pool::async_request(
+    const request_pdu auto& pdu,
+    std::chrono::steady_clock::duration response_timeout,
+    CompletionToken&& token)
+{
+    return asio::async_compose<
+        decltype(token),
+        void(boost::system::error_code, pdu_variant, command_status)>(
+        [this,
+         &pdu,
+         m        = std::shared_ptr<member>{},
+         start    = clock::time_point{},
+         deadline = response_timeout == clock::duration::max()
+             ? clock::time_point::max()
+             : clock::now() + response_timeout,
+         c = asio::coroutine{}](
+            auto&& self,
+            boost::system::error_code ec  = {},
+            pdu_variant response          = {},
+            command_status command_status = {}) mutable
+        {
+            BOOST_ASIO_CORO_REENTER(c)
+            {
+                for(;;)
+                {
+                    while(!(m = select_member()))
+                    {
+                        // posted, so the completion never runs inline
+                        if(stopped_)
+                        {
+                            BOOST_ASIO_CORO_YIELD
+                            asio::post(std::move(self));
+                            return self.complete(
+                                asio::error::operation_aborted, {}, {});
+                        }
+
+                        if(clock::now() >= deadline)
+                        {
+                            BOOST_ASIO_CORO_YIELD
+                            asio::post(std::move(self));
+                            return self.complete(
+                                error::response_timeout, {}, {});
+                        }
+
+                        // waiting for a bound session doesn't write, so it can
+                        // be cancelled at the deadline
+                        BOOST_ASIO_CORO_YIELD
+                        if(deadline == clock::time_point::max())
+                            ready_cv_.async_wait(std::move(self));
+                        else
+                            ready_cv_.async_wait(asio::cancel_after(
+                                deadline - clock::now(), std::move(self)));
+                        if(!!self.cancelled())
+                            return self.complete(
+                                asio::error::operation_aborted, {}, {});
+                    }
+
+                    m->outstanding++;
+                    start = clock::now();
+
+                    BOOST_ASIO_CORO_YIELD
+                    m->session->async_request(
+                        pdu,
+                        deadline == clock::time_point::max()
+                            ? clock::duration::max()
+                            : std::max(deadline - start, clock::duration{}),
+                        std::move(self));
+
+                    m->outstanding--;
+                    if(!ec || !replay_ || !is_session_failure(ec) ||
+                       stopping_ || !!self.cancelled())
+                        break;
+
+                    // the session is dead, don't select it until it's replaced
+                    m->bound = false;
+                }
+
+                if(!ec)
+                {
+                    // exponentially weighted moving average, alpha = 1/8
+                    const auto sample = clock::now() - start;
+                    m->latency = m->latency == clock::duration{}
+                        ? sample
+                        : m->latency + (sample - m->latency) / 8;
+                }
+
+                self.complete(ec, std::move(response), command_status);
+            }
+        },
+        token,
+        executor_);
+}
+
+template<
+    asio::completion_token_for<void(boost::system::error_code)> CompletionToken>
+auto
+session_pool::async_run(CompletionToken&& token)
+{
+    return asio::
+        async_compose<decltype(token), void(boost::system::error_code)>(
+            [this, c = asio::coroutine{}](
+                auto&& self, boost::system::error_code = {}) mutable
+            {
+                BOOST_ASIO_CORO_REENTER(c)
+                {
+                    self.reset_cancellation_state(
+                        asio::enable_total_cancellation());
+
+                    stopping_ = false;
+                    stopped_  = false;
+                    running_  = members_.size();
+                    for(auto i = std::size_t{}; i < members_.size(); i++)
+                    {
+                        auto on_exit = [this](boost::system::error_code)
+                        {
+                            if(--running_ == 0)
+                                run_cv_.cancel();
+                        };
+                        asio::async_compose<
+                            decltype(on_exit),
+                            void(boost::system::error_code)>(
+                            member_op{ this, i }, on_exit, executor_);
+                    }
+
+                    // only cancellation wakes up the first wait
+                    BOOST_ASIO_CORO_YIELD
+                    run_cv_.async_wait(std::move(self));
+
+                    stop_members();
+                    while(running_ != 0)
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        run_cv_.async_wait(std::move(self));
+                    }
+
+                    stopped_ = true;
+                    ready_cv_.cancel();
+                    self.complete(asio::error::operation_aborted);
+                }
+            },
+            token,
+            executor_);
+}
+} // namespace smpp
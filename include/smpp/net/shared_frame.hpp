@@ -0,0 +1,68 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/common/command_id.hpp>
+#include <smpp/common/request_pdu.hpp>
+#include <smpp/common/serialization.hpp>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace smpp
+{
+/// An immutable, serialized request PDU that many sessions can send
+/**
+ * The body of the PDU, everything after the header, is serialized once into
+ * a reference-counted buffer. Copies of a shared_frame share that buffer, and
+ * sessions send it with their own header through a gather write, so fanning
+ * out a deliver_sm or alert_notification to many sessions costs a single
+ * serialization and a single buffer.
+ */
+class shared_frame
+{
+    smpp::command_id command_id_{};
+    std::shared_ptr<const std::vector<uint8_t>> body_;
+
+public:
+    /// Construct a shared_frame from a request PDU
+    /**
+     * @throw std::length_error if a field of the PDU exceeds its limit.
+     *
+     * @param pdu The request PDU
+     */
+    template<typename PDU>
+        requires request_pdu<PDU>
+    explicit shared_frame(const PDU& pdu)
+        : command_id_{ PDU::command_id }
+    {
+        auto body = std::make_shared<std::vector<uint8_t>>();
+        serialize_to(body.get(), pdu);
+        body_ = std::move(body);
+    }
+
+    /// Return the command_id of the PDU
+    smpp::command_id
+    command_id() const noexcept
+    {
+        return command_id_;
+    }
+
+    /// Return the serialized body of the PDU, without its header
+    std::span<const uint8_t>
+    body() const noexcept
+    {
+        return *body_;
+    }
+
+    /// Return the number of shared_frame objects that share the body
+    long
+    use_count() const noexcept
+    {
+        return body_.use_count();
+    }
+};
+} // namespace smpp
@@ -0,0 +1,333 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#endif
+
+namespace smpp
+{
+namespace asio = boost::asio;
+
+#if defined(SO_REUSEPORT)
+/// The SO_REUSEPORT socket option
+/**
+ * It lets multiple sockets bind to the same endpoint, and for TCP the kernel
+ * spreads incoming connections between their acceptors. It meets the
+ * SettableSocketOption and GettableSocketOption requirements of Asio.
+ */
+class reuse_port
+{
+    int value_;
+
+public:
+    /// Construct a reuse_port option
+    explicit reuse_port(bool value = false) noexcept
+        : value_{ value ? 1 : 0 }
+    {
+    }
+
+    /// Return the value of the option
+    bool
+    value() const noexcept
+    {
+        return value_ != 0;
+    }
+
+    template<typename Protocol>
+    int
+    level(const Protocol&) const noexcept
+    {
+        return SOL_SOCKET;
+    }
+
+    template<typename Protocol>
+    int
+    name(const Protocol&) const noexcept
+    {
+        return SO_REUSEPORT;
+    }
+
+    template<typename Protocol>
+    int*
+    data(const Protocol&) noexcept
+    {
+        return &value_;
+    }
+
+    template<typename Protocol>
+    const int*
+    data(const Protocol&) const noexcept
+    {
+        return &value_;
+    }
+
+    template<typename Protocol>
+    std::size_t
+    size(const Protocol&) const noexcept
+    {
+        return sizeof(value_);
+    }
+
+    template<typename Protocol>
+    void
+    resize(const Protocol&, std::size_t size)
+    {
+        if(size != sizeof(value_))
+            throw std::length_error{ "reuse_port socket option resize" };
+    }
+};
+#endif
+
+/// A server that runs one io_context per core
+/**
+ * Each core runs its own io_context on its own thread, pinned to one of the
+ * CPUs in the affinity mask of the process, with its own acceptor listening
+ * on the same endpoint with SO_REUSEPORT, so the kernel spreads incoming
+ * connections between the cores. A connection
+ * stays on the core that has accepted it for its whole lifetime, and the
+ * sessions and buffers that the session handler creates are allocated by the
+ * owning thread, which places them on its local NUMA node under the default
+ * first-touch policy. Cores don't share any state, work is passed between them
+ * explicitly with post.
+ */
+class thread_per_core_server
+{
+public:
+    using session_handler =
+        std::function<void(asio::ip::tcp::socket, std::size_t)>;
+
+private:
+    struct core
+    {
+        asio::io_context ioc{ 1 };
+        std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
+        std::exception_ptr eptr;
+    };
+
+    asio::ip::tcp::endpoint endpoint_;
+    std::vector<std::unique_ptr<core>> cores_;
+    session_handler session_handler_;
+    std::vector<int> cpus_; // the CPUs that the process may run on
+    bool pin_threads_{ true };
+
+public:
+    /// Construct a thread_per_core_server
+    /**
+     * @param endpoint The endpoint that acceptors would listen on
+     * @param cores The number of cores, zero means one per CPU in the
+     * affinity mask of the process, or one per hardware thread where the
+     * mask is not available
+     */
+    explicit thread_per_core_server(
+        asio::ip::tcp::endpoint endpoint,
+        std::size_t cores = 0);
+
+    /// Return the number of cores
+    std::size_t
+    cores() const noexcept;
+
+    /// Return the executor of a core
+    asio::io_context::executor_type
+    get_executor(std::size_t core) noexcept;
+
+    /// Set whether each thread should be pinned to its CPU
+    /**
+     * Pinning is only supported on Linux, and it is enabled by default. The
+     * thread of core i is pinned to the i-th CPU of the affinity mask that the
+     * process had when the server was constructed, wrapping around if there
+     * are more cores than CPUs.
+     */
+    void
+    set_pin_threads(bool pin);
+
+    /// Post a function to be invoked on a core
+    /**
+     * This is the only way that cores should communicate with each other.
+     */
+    template<typename Function>
+    void
+    post(std::size_t core, Function&& function);
+
+    /// Run the server
+    /**
+     * This function opens the acceptors and runs the cores, the calling thread
+     * runs the first core. Each accepted socket is passed to the handler on
+     * the thread of the core that has accepted it, along with the index of
+     * the core. It blocks until the server is stopped, and rethrows the first
+     * exception that has escaped a core.
+     *
+     * @param handler The session handler
+     */
+    void
+    run(session_handler handler);
+
+    /// Stop the server
+    /**
+     * This function can be called from any thread.
+     */
+    void
+    stop();
+
+private:
+    void
+    run_core(std::size_t index);
+
+    void
+    do_accept(std::size_t index);
+};
+
+inline thread_per_core_server::thread_per_core_server(
+    asio::ip::tcp::endpoint endpoint,
+    std::size_t cores)
+    : endpoint_{ std::move(endpoint) }
+{
+#if defined(__linux__)
+    auto set = cpu_set_t{};
+    if(::sched_getaffinity(0, sizeof(set), &set) == 0)
+        for(auto cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if(CPU_ISSET(cpu, &set))
+                cpus_.push_back(cpu);
+#endif
+
+    if(cores == 0)
+        cores = !cpus_.empty()
+            ? cpus_.size()
+            : std::max(1u, std::thread::hardware_concurrency());
+
+    cores_.reserve(cores);
+    for(auto i = std::size_t{}; i < cores; i++)
+        cores_.push_back(std::make_unique<core>());
+}
+
+inline std::size_t
+thread_per_core_server::cores() const noexcept
+{
+    return cores_.size();
+}
+
+inline asio::io_context::executor_type
+thread_per_core_server::get_executor(std::size_t core) noexcept
+{
+    return cores_[core]->ioc.get_executor();
+}
+
+inline void
+thread_per_core_server::set_pin_threads(bool pin)
+{
+    pin_threads_ = pin;
+}
+
+template<typename Function>
+void
+thread_per_core_server::post(std::size_t core, Function&& function)
+{
+    asio::post(cores_[core]->ioc, std::forward<Function>(function));
+}
+
+inline void
+thread_per_core_server::run(session_handler handler)
+{
+    session_handler_ = std::move(handler);
+
+    for(auto& c : cores_)
+        c->ioc.restart();
+
+    auto threads = std::vector<std::thread>{};
+    threads.reserve(cores_.size() - 1);
+    for(auto i = std::size_t{ 1 }; i < cores_.size(); i++)
+        threads.emplace_back([this, i] { run_core(i); });
+
+    run_core(0);
+
+    for(auto& t : threads)
+        t.join();
+
+    for(auto& c : cores_)
+        if(c->eptr)
+            std::rethrow_exception(std::exchange(c->eptr, nullptr));
+}
+
+inline void
+thread_per_core_server::stop()
+{
+    for(auto& c : cores_)
+        c->ioc.stop();
+}
+
+inline void
+thread_per_core_server::run_core(std::size_t index)
+{
+    auto& c = *cores_[index];
+    try
+    {
+#if defined(__linux__)
+        if(pin_threads_ && !cpus_.empty())
+        {
+            auto set = cpu_set_t{};
+            CPU_ZERO(&set);
+            CPU_SET(cpus_[index % cpus_.size()], &set);
+            // best effort, the mask might have changed since construction
+            ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        }
+#endif
+        // the acceptor is opened on the owning thread, after pinning
+        c.acceptor = std::make_unique<asio::ip::tcp::acceptor>(c.ioc);
+        c.acceptor->open(endpoint_.protocol());
+        c.acceptor->set_option(asio::socket_base::reuse_address{ true });
+#if defined(SO_REUSEPORT)
+        c.acceptor->set_option(reuse_port{ true });
+#endif
+        c.acceptor->bind(endpoint_);
+        c.acceptor->listen();
+
+        do_accept(index);
+        c.ioc.run();
+    }
+    catch(...)
+    {
+        c.eptr = std::current_exception();
+        stop();
+    }
+
+    c.acceptor.reset();
+}
+
+inline void
+thread_per_core_server::do_accept(std::size_t index)
+{
+    cores_[index]->acceptor->async_accept(
+        [this,
+         index](boost::system::error_code ec, asio::ip::tcp::socket socket)
+        {
+            if(ec == asio::error::operation_aborted)
+                return;
+
+            // other errors, like running out of file descriptors, are
+            // transient and the acceptor keeps accepting
+            if(!ec)
+                session_handler_(std::move(socket), index);
+
+            do_accept(index);
+        });
+}
+} // namespace smpp
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <smpp/param/data_coding.hpp>
+#include <smpp/param/dest_address.hpp>
 #include <smpp/param/esm_class.hpp>
 #include <smpp/param/interface_version.hpp>
 #include <smpp/param/message_state.hpp>
@@ -14,3 +15,4 @@
 #include <smpp/param/registered_delivery.hpp>
 #include <smpp/param/replace_if_present_flag.hpp>
 #include <smpp/param/ton.hpp>
+#include <smpp/param/unsuccess_sme.hpp>
@@ -0,0 +1,241 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/param/detail/packed_iterator.hpp>
+#include <smpp/param/npi.hpp>
+#include <smpp/param/ton.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smpp
+{
+enum class dest_flag : uint8_t
+{
+    sme_address       = 0x01,
+    distribution_list = 0x02
+};
+
+/// A destination of submit_multi
+struct dest_address
+{
+    smpp::dest_flag dest_flag{ dest_flag::sme_address };
+
+    // Only meaningful for SME addresses
+    smpp::ton dest_addr_ton{ ton::unknown };
+    smpp::npi dest_addr_npi{ npi::unknown };
+
+    // The destination_addr of an SME address or the dl_name of a
+    // distribution list, a view into its dest_address_list
+    std::string_view address{};
+
+    bool
+    operator==(const dest_address&) const = default;
+};
+
+namespace detail
+{
+inline dest_address
+read_dest_address(const char*& pos) noexcept
+{
+    auto result      = dest_address{};
+    result.dest_flag = static_cast<dest_flag>(*pos++);
+    if(result.dest_flag == dest_flag::sme_address)
+    {
+        result.dest_addr_ton = static_cast<ton>(*pos++);
+        result.dest_addr_npi = static_cast<npi>(*pos++);
+    }
+    result.address = pos; // up to its null character
+    pos += result.address.size() + 1;
+    return result;
+}
+} // namespace detail
+
+/// The dest_address list of submit_multi
+/**
+ * Destinations are kept back to back in their wire format, in a single
+ * buffer, so adding a destination doesn't allocate once the buffer has grown
+ * and serialization is a single copy into the send buffer.
+ */
+class dest_address_list
+{
+    static constexpr std::size_t max_address_length{ 20 };
+
+    std::string buf_;
+    uint8_t size_{};
+
+public:
+    using iterator =
+        detail::packed_iterator<dest_address, detail::read_dest_address>;
+
+    // number_of_dests is a single octet
+    static constexpr std::size_t max_size{ 255 };
+
+    dest_address_list() = default;
+
+    /// Construct a dest_address_list from buffer
+    /**
+     * Constructs a dest_address_list from buffer and is intended to be used by
+     * pdu deserializer.
+     *
+     * @param buf The buffer that starts with number_of_dests.
+     */
+    explicit dest_address_list(std::span<const uint8_t>* buf)
+    {
+        if(buf->empty())
+            throw std::length_error{
+                "buf size should be at least 1, field_name:number_of_dests"
+            };
+
+        const auto count = (*buf)[0];
+        auto pos         = std::size_t{ 1 };
+        for(auto i = 0; i < count; i++)
+        {
+            if(pos >= buf->size())
+                throw std::length_error{ "dest_address exceeds buf" };
+
+            const auto flag = static_cast<dest_flag>((*buf)[pos++]);
+            if(flag == dest_flag::sme_address)
+                pos += 2; // dest_addr_ton and dest_addr_npi
+            else if(flag != dest_flag::distribution_list)
+                throw std::length_error{ "dest_flag is invalid" };
+
+            const auto begin = buf->begin() + std::min(pos, buf->size());
+            const auto null  = std::find(begin, buf->end(), '\0');
+            if(null == buf->end())
+                throw std::length_error{
+                    "c_octet_str can't find null character, "
+                    "field_name:dest_address"
+                };
+            if(static_cast<std::size_t>(null - begin) > max_address_length)
+                throw std::length_error{
+                    "c_octet_str exceed its limit, field_name:dest_address"
+                };
+            pos = static_cast<std::size_t>(null - buf->begin()) + 1;
+        }
+
+        buf_.assign(buf->begin() + 1, buf->begin() + pos);
+        size_ = count;
+        *buf  = buf->last(buf->size() - pos);
+    }
+
+    bool
+    operator==(const dest_address_list&) const = default;
+
+    /// Serialize the dest_address_list
+    /**
+     * This function serializes number_of_dests and the destinations and is
+     * intended to be used by pdu serializer.
+     *
+     * @param vec The vector that the destinations would be appended to.
+     */
+    void
+    serialize(std::vector<uint8_t>* vec) const
+    {
+        vec->push_back(size_);
+        vec->insert(vec->end(), buf_.begin(), buf_.end());
+    }
+
+    /// Return the number of destinations
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    iterator
+    begin() const noexcept
+    {
+        return iterator{ buf_.data() };
+    }
+
+    iterator
+    end() const noexcept
+    {
+        return iterator{ buf_.data() + buf_.size() };
+    }
+
+    /// Reserve room for a number of SME addresses
+    void
+    reserve(std::size_t count)
+    {
+        buf_.reserve(count * (3 + max_address_length + 1));
+    }
+
+    /// Remove all destinations, keeping the buffer
+    void
+    clear() noexcept
+    {
+        buf_.clear();
+        size_ = 0;
+    }
+
+    /// Add an SME address
+    /**
+     * @throw std::length_error if the list has max_size destinations or the
+     * address is longer than 20 characters.
+     * @throw std::invalid_argument if the address has a null character.
+     *
+     * @param ton The dest_addr_ton
+     * @param npi The dest_addr_npi
+     * @param address The destination_addr
+     */
+    void
+    add_sme_address(smpp::ton ton, smpp::npi npi, std::string_view address)
+    {
+        check(address);
+        buf_.push_back(static_cast<char>(dest_flag::sme_address));
+        buf_.push_back(static_cast<char>(ton));
+        buf_.push_back(static_cast<char>(npi));
+        buf_.append(address);
+        buf_.push_back('\0');
+        size_++;
+    }
+
+    /// Add a distribution list
+    /**
+     * @throw std::length_error if the list has max_size destinations or the
+     * name is longer than 20 characters.
+     * @throw std::invalid_argument if the name has a null character.
+     *
+     * @param dl_name The name of the distribution list
+     */
+    void
+    add_distribution_list(std::string_view dl_name)
+    {
+        check(dl_name);
+        buf_.push_back(static_cast<char>(dest_flag::distribution_list));
+        buf_.append(dl_name);
+        buf_.push_back('\0');
+        size_++;
+    }
+
+private:
+    void
+    check(std::string_view address) const
+    {
+        if(size_ == max_size)
+            throw std::length_error{ "dest_address_list is full" };
+        if(address.size() > max_address_length)
+            throw std::length_error{
+                "c_octet_str exceed its limit, field_name:dest_address"
+            };
+        if(address.find('\0') != std::string_view::npos)
+            throw std::invalid_argument{ "address has a null character" };
+    }
+};
+} // namespace smpp
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+namespace smpp::detail
+{
+// Iterates over records that are packed back to back in their wire format,
+// Read decodes the record at pos and advances pos past it
+template<typename T, T (*Read)(const char*& pos) noexcept>
+class packed_iterator
+{
+    const char* pos_{ nullptr };
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = T;
+
+    packed_iterator() = default;
+
+    explicit packed_iterator(const char* pos) noexcept
+        : pos_{ pos }
+    {
+    }
+
+    T
+    operator*() const noexcept
+    {
+        auto pos = pos_;
+        return Read(pos);
+    }
+
+    packed_iterator&
+    operator++() noexcept
+    {
+        Read(pos_);
+        return *this;
+    }
+
+    packed_iterator
+    operator++(int) noexcept
+    {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool
+    operator==(const packed_iterator&) const = default;
+};
+} // namespace smpp::detail
@@ -10,6 +10,7 @@ namespace smpp
 {
 enum class interface_version : uint8_t
 {
-    smpp_3_4 = 0x34
+    smpp_3_4 = 0x34,
+    smpp_5_0 = 0x50
 };
 } // namespace smpp
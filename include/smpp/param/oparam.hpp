@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <span>
+#include <string_view>
 #include <vector>
 
 namespace smpp
@@ -16,7 +17,8 @@ namespace smpp
 class oparam
 {
     static auto constexpr header_length{ 4 };
-    std::map<oparam_tag, std::string> oparams_;
+    // some optional parameters, like broadcast_area_identifier, can repeat
+    std::multimap<oparam_tag, std::string> oparams_;
 
 public:
     oparam() = default;
@@ -85,7 +87,8 @@ public:
 
     /// Erase an optional parameter
     /**
-     * This function erase an optional parameter by its oparam_tag.
+     * This function erase an optional parameter by its oparam_tag, with all
+     * of its values.
      *
      * @return A boolean indicating if there was an optional parameter with this
      * oparam_tag.
@@ -109,14 +112,15 @@ public:
      * @param tag The oparam_tag to be located.
      */
     bool
-    contains(oparam_tag tag)
+    contains(oparam_tag tag) const
     {
         return oparams_.contains(tag);
     }
 
     /// Get an optional parameter as a string.
     /**
-     * This function gets an optional parameter as a string.
+     * This function gets an optional parameter as a string, the first one if
+     * it repeats.
      *
      * @throw std::runtime_error if optional parameter does not exist.
      *
@@ -127,16 +131,35 @@ public:
     const std::string&
     get_as_string(oparam_tag tag) const
     {
-        const auto& it = oparams_.find(tag);
-        if(it == oparams_.end())
+        const auto it = oparams_.lower_bound(tag);
+        if(it == oparams_.end() || it->first != tag)
             throw std::runtime_error{ "oparam does not exist" };
         return it->second;
     }
 
+    /// Get all the optional parameters with the given oparam_tag as strings.
+    /**
+     * This function gets the values of an optional parameter that can repeat,
+     * like broadcast_area_identifier, in the order they were added.
+     *
+     * @return The values, which are views into the oparam.
+     *
+     * @param tag The oparam_tag to be located.
+     */
+    std::vector<std::string_view>
+    get_all_as_string(oparam_tag tag) const
+    {
+        auto result       = std::vector<std::string_view>{};
+        auto [begin, end] = oparams_.equal_range(tag);
+        for(; begin != end; ++begin)
+            result.emplace_back(begin->second);
+        return result;
+    }
+
     /// Set an optional parameter as a string.
     /**
      * This function sets an optional parameter as a string.
-     * If a value with the same oparam_tag already exists it will be replaced.
+     * If values with the same oparam_tag already exist they will be replaced.
      *
      * @throw std::length_error if string val has length bigger than 65535.
      *
@@ -146,12 +169,33 @@ public:
     void
     set_as_string(oparam_tag tag, std::string val)
     {
-        if(val.size() > 65535)
-            throw std::length_error{
-                "oparam value length is bigger than 65535"
-            };
+        check_length(val);
+        auto [begin, end] = oparams_.equal_range(tag);
+        if(begin != end && std::next(begin) == end)
+        {
+            // the node of a single value is reused
+            begin->second = std::move(val);
+            return;
+        }
+        oparams_.erase(begin, end);
+        oparams_.emplace(tag, std::move(val));
+    }
 
-        oparams_[tag] = std::move(val);
+    /// Add an optional parameter as a string.
+    /**
+     * This function adds another value of an optional parameter that can
+     * repeat, like broadcast_area_identifier, after the existing ones.
+     *
+     * @throw std::length_error if string val has length bigger than 65535.
+     *
+     * @param val The string to be added.
+     * @param tag The oparam_tag of the value.
+     */
+    void
+    add_as_string(oparam_tag tag, std::string val)
+    {
+        check_length(val);
+        oparams_.emplace(tag, std::move(val));
     }
 
     /// Get an optional parameter as an enum with an underlying type of uint8_t.
@@ -191,7 +235,18 @@ public:
     set_as_enum_u8(oparam_tag tag, T val)
         requires(std::is_same_v<std::underlying_type_t<T>, uint8_t>)
     {
-        oparams_[tag] = static_cast<uint8_t>(val);
+        oparams_.erase(tag);
+        oparams_.emplace(tag, std::string(1, static_cast<char>(val)));
+    }
+
+private:
+    static void
+    check_length(const std::string& val)
+    {
+        if(val.size() > 65535)
+            throw std::length_error{
+                "oparam value length is bigger than 65535"
+            };
     }
 };
 } // namespace smpp
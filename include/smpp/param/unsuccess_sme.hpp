@@ -0,0 +1,209 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/common/command_status.hpp>
+#include <smpp/param/detail/packed_iterator.hpp>
+#include <smpp/param/npi.hpp>
+#include <smpp/param/ton.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smpp
+{
+/// A destination that submit_multi couldn't be delivered to
+struct unsuccess_sme
+{
+    smpp::ton dest_addr_ton{ ton::unknown };
+    smpp::npi dest_addr_npi{ npi::unknown };
+
+    // A view into its unsuccess_sme_list
+    std::string_view dest_addr{};
+
+    smpp::command_status error_status_code{ command_status::rok };
+
+    bool
+    operator==(const unsuccess_sme&) const = default;
+};
+
+namespace detail
+{
+inline unsuccess_sme
+read_unsuccess_sme(const char*& pos) noexcept
+{
+    auto result          = unsuccess_sme{};
+    result.dest_addr_ton = static_cast<ton>(*pos++);
+    result.dest_addr_npi = static_cast<npi>(*pos++);
+    result.dest_addr     = pos; // up to its null character
+    pos += result.dest_addr.size() + 1;
+
+    auto status = uint32_t{};
+    for(auto i = 0; i < 4; i++)
+        status = status << 8 | static_cast<uint8_t>(*pos++);
+    result.error_status_code = static_cast<command_status>(status);
+    return result;
+}
+} // namespace detail
+
+/// The unsuccess_sme list of submit_multi_resp
+/**
+ * Like dest_address_list, the entries are kept back to back in their wire
+ * format in a single buffer.
+ */
+class unsuccess_sme_list
+{
+    static constexpr std::size_t max_address_length{ 20 };
+
+    std::string buf_;
+    uint8_t size_{};
+
+public:
+    using iterator =
+        detail::packed_iterator<unsuccess_sme, detail::read_unsuccess_sme>;
+
+    // no_unsuccess is a single octet
+    static constexpr std::size_t max_size{ 255 };
+
+    unsuccess_sme_list() = default;
+
+    /// Construct an unsuccess_sme_list from buffer
+    /**
+     * Constructs an unsuccess_sme_list from buffer and is intended to be used
+     * by pdu deserializer.
+     *
+     * @param buf The buffer that starts with no_unsuccess.
+     */
+    explicit unsuccess_sme_list(std::span<const uint8_t>* buf)
+    {
+        if(buf->empty())
+            throw std::length_error{
+                "buf size should be at least 1, field_name:no_unsuccess"
+            };
+
+        const auto count = (*buf)[0];
+        auto pos         = std::size_t{ 1 };
+        for(auto i = 0; i < count; i++)
+        {
+            pos += 2; // dest_addr_ton and dest_addr_npi
+
+            const auto begin = buf->begin() + std::min(pos, buf->size());
+            const auto null  = std::find(begin, buf->end(), '\0');
+            if(null == buf->end())
+                throw std::length_error{
+                    "c_octet_str can't find null character, "
+                    "field_name:unsuccess_sme"
+                };
+            if(static_cast<std::size_t>(null - begin) > max_address_length)
+                throw std::length_error{
+                    "c_octet_str exceed its limit, field_name:unsuccess_sme"
+                };
+
+            pos = static_cast<std::size_t>(null - buf->begin()) + 1 + 4;
+            if(pos > buf->size())
+                throw std::length_error{
+                    "buf size should be at least 4, "
+                    "field_name:error_status_code"
+                };
+        }
+
+        buf_.assign(buf->begin() + 1, buf->begin() + pos);
+        size_ = count;
+        *buf  = buf->last(buf->size() - pos);
+    }
+
+    bool
+    operator==(const unsuccess_sme_list&) const = default;
+
+    /// Serialize the unsuccess_sme_list
+    /**
+     * This function serializes no_unsuccess and the entries and is intended
+     * to be used by pdu serializer.
+     *
+     * @param vec The vector that the entries would be appended to.
+     */
+    void
+    serialize(std::vector<uint8_t>* vec) const
+    {
+        vec->push_back(size_);
+        vec->insert(vec->end(), buf_.begin(), buf_.end());
+    }
+
+    /// Return the number of entries
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    iterator
+    begin() const noexcept
+    {
+        return iterator{ buf_.data() };
+    }
+
+    iterator
+    end() const noexcept
+    {
+        return iterator{ buf_.data() + buf_.size() };
+    }
+
+    /// Remove all entries, keeping the buffer
+    void
+    clear() noexcept
+    {
+        buf_.clear();
+        size_ = 0;
+    }
+
+    /// Add an entry
+    /**
+     * @throw std::length_error if the list has max_size entries or the
+     * address is longer than 20 characters.
+     * @throw std::invalid_argument if the address has a null character.
+     *
+     * @param ton The dest_addr_ton
+     * @param npi The dest_addr_npi
+     * @param dest_addr The destination address
+     * @param error_status_code The reason of the failure
+     */
+    void
+    add(smpp::ton ton,
+        smpp::npi npi,
+        std::string_view dest_addr,
+        command_status error_status_code)
+    {
+        if(size_ == max_size)
+            throw std::length_error{ "unsuccess_sme_list is full" };
+        if(dest_addr.size() > max_address_length)
+            throw std::length_error{
+                "c_octet_str exceed its limit, field_name:unsuccess_sme"
+            };
+        if(dest_addr.find('\0') != std::string_view::npos)
+            throw std::invalid_argument{ "address has a null character" };
+
+        buf_.push_back(static_cast<char>(ton));
+        buf_.push_back(static_cast<char>(npi));
+        buf_.append(dest_addr);
+        buf_.push_back('\0');
+
+        const auto status = static_cast<uint32_t>(error_status_code);
+        for(auto shift = 24; shift >= 0; shift -= 8)
+            buf_.push_back(static_cast<char>(status >> shift));
+        size_++;
+    }
+};
+} // namespace smpp
@@ -11,6 +11,10 @@
 #include <smpp/pdu/bind_transceiver_resp.hpp>
 #include <smpp/pdu/bind_transmitter.hpp>
 #include <smpp/pdu/bind_transmitter_resp.hpp>
+#include <smpp/pdu/broadcast_sm.hpp>
+#include <smpp/pdu/broadcast_sm_resp.hpp>
+#include <smpp/pdu/cancel_broadcast_sm.hpp>
+#include <smpp/pdu/cancel_broadcast_sm_resp.hpp>
 #include <smpp/pdu/cancel_sm.hpp>
 #include <smpp/pdu/cancel_sm_resp.hpp>
 #include <smpp/pdu/data_sm.hpp>
@@ -19,9 +23,13 @@
 #include <smpp/pdu/deliver_sm_resp.hpp>
 #include <smpp/pdu/generic_nack.hpp>
 #include <smpp/pdu/outbind.hpp>
+#include <smpp/pdu/query_broadcast_sm.hpp>
+#include <smpp/pdu/query_broadcast_sm_resp.hpp>
 #include <smpp/pdu/query_sm.hpp>
 #include <smpp/pdu/query_sm_resp.hpp>
 #include <smpp/pdu/replace_sm.hpp>
 #include <smpp/pdu/replace_sm_resp.hpp>
+#include <smpp/pdu/submit_multi.hpp>
+#include <smpp/pdu/submit_multi_resp.hpp>
 #include <smpp/pdu/submit_sm.hpp>
 #include <smpp/pdu/submit_sm_resp.hpp>
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/common.hpp>
+#include <smpp/param.hpp>
+
+namespace smpp
+{
+// SMPP 5.0, the message content is carried in the message_payload and the
+// broadcast areas in repeated broadcast_area_identifier optional parameters
+struct broadcast_sm
+{
+    static constexpr auto command_id{ smpp::command_id::broadcast_sm };
+
+    std::string service_type{};
+    smpp::ton source_addr_ton{ ton::unknown };
+    smpp::npi source_addr_npi{ npi::unknown };
+    std::string source_addr{};
+    std::string message_id{};
+    smpp::priority_flag priority_flag{ priority_flag::gsm_non_priority };
+    std::string schedule_delivery_time{};
+    std::string validity_period{};
+    smpp::replace_if_present_flag replace_if_present_flag{
+        replace_if_present_flag::no
+    };
+    smpp::data_coding data_coding{ data_coding::defaults };
+    uint8_t sm_default_msg_id{};
+    smpp::oparam oparam{};
+
+    bool
+    operator==(const broadcast_sm&) const = default;
+};
+
+namespace detail
+{
+template<>
+inline consteval auto
+pdu_meta<broadcast_sm>()
+{
+    return std::tuple{
+        mem<c_octet_str<6>>(&broadcast_sm::service_type, "service_type"),
+        mem<enum_u8>(&broadcast_sm::source_addr_ton, "source_addr_ton"),
+        mem<enum_u8>(&broadcast_sm::source_addr_npi, "source_addr_npi"),
+        mem<c_octet_str<21>>(&broadcast_sm::source_addr, "source_addr"),
+        mem<c_octet_str<65>>(&broadcast_sm::message_id, "message_id"),
+        mem<enum_u8>(&broadcast_sm::priority_flag, "priority_flag"),
+        mem<c_octet_str<17>>(
+            &broadcast_sm::schedule_delivery_time, "schedule_delivery_time"),
+        mem<c_octet_str<17>>(&broadcast_sm::validity_period, "validity_period"),
+        mem<enum_u8>(
+            &broadcast_sm::replace_if_present_flag, "replace_if_present_flag"),
+        mem<enum_u8>(&broadcast_sm::data_coding, "data_coding"),
+        mem<u8>(&broadcast_sm::sm_default_msg_id, "sm_default_msg_id"),
+        mem<smart>(&broadcast_sm::oparam, "oparam")
+    };
+}
+} // namespace detail
+} // namespace smpp
@@ -0,0 +1,35 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/common.hpp>
+#include <smpp/param.hpp>
+
+namespace smpp
+{
+struct submit_multi_resp
+{
+    static constexpr auto command_id{ smpp::command_id::submit_multi_resp };
+
+    std::string message_id{};
+    smpp::unsuccess_sme_list unsuccess_smes{};
+
+    bool
+    operator==(const submit_multi_resp&) const = default;
+};
+
+namespace detail
+{
+template<>
+inline consteval auto
+pdu_meta<submit_multi_resp>()
+{
+    return std::tuple{
+        mem<c_octet_str<65>>(&submit_multi_resp::message_id, "message_id"),
+        mem<smart>(&submit_multi_resp::unsuccess_smes, "unsuccess_sme")
+    };
+}
+} // namespace detail
+} // namespace smpp
@@ -5,5 +5,13 @@
 #pragma once
 
 #include <smpp/utility/data_coding_unicode.hpp>
+#include <smpp/utility/delivery_receipt.hpp>
+#include <smpp/utility/encoding_planner.hpp>
+#include <smpp/utility/gsm_national_language.hpp>
+#include <smpp/utility/gsm_septet.hpp>
+#include <smpp/utility/message_reassembler.hpp>
+#include <smpp/utility/message_scheduler.hpp>
+#include <smpp/utility/message_segmenter.hpp>
 #include <smpp/utility/short_message.hpp>
+#include <smpp/utility/smpp_time.hpp>
 #include <smpp/utility/unicode_converter.hpp>
@@ -0,0 +1,368 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/param/message_state.hpp>
+#include <smpp/param/oparam.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cinttypes>
+#include <optional>
+#include <string_view>
+
+namespace smpp
+{
+/// The fields of a delivery receipt
+/**
+ * The string fields of a parsed receipt are views into the parsed text, and
+ * the PDU, that should outlive the receipt.
+ */
+struct delivery_receipt
+{
+    // The message ID that the SMSC has returned for the submitted message
+    std::string_view id{};
+
+    // Number of short messages originally submitted
+    uint32_t submitted{};
+
+    // Number of short messages delivered
+    uint32_t delivered{};
+
+    // The time the message was submitted, zero if absent
+    std::chrono::sys_seconds submit_date{};
+
+    // The time the message reached its final state, zero if absent
+    std::chrono::sys_seconds done_date{};
+
+    // The final state of the message
+    std::optional<message_state> state{};
+
+    // Network or SMSC specific error code
+    std::string_view error{};
+
+    // The first characters of the message
+    std::string_view text{};
+
+    bool
+    operator==(const delivery_receipt&) const = default;
+};
+
+// Large enough for a receipt with a 65 octet id
+inline constexpr std::size_t max_delivery_receipt_size{ 200 };
+
+namespace detail
+{
+inline constexpr char
+to_lower(char c) noexcept
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Compares a key case-insensitively, ignoring spaces and underscores, so
+// "submit date", "Submit_Date" and "submitdate" are all the same
+inline constexpr bool
+receipt_key_equals(std::string_view key, std::string_view expected) noexcept
+{
+    auto it = expected.begin();
+    for(auto c : key)
+    {
+        if(c == ' ' || c == '_')
+            continue;
+        if(it == expected.end() || to_lower(c) != *it++)
+            return false;
+    }
+    return it == expected.end();
+}
+
+inline constexpr std::optional<message_state>
+parse_receipt_state(std::string_view stat) noexcept
+{
+    struct state_prefix
+    {
+        std::string_view prefix;
+        message_state state;
+    };
+
+    // vendors send both the 7 letter forms and the full words
+    constexpr state_prefix prefixes[] = {
+        { "deliv", message_state::delivered },
+        { "undel", message_state::undeliverable },
+        { "expir", message_state::expired },
+        { "delet", message_state::deleted },
+        { "accep", message_state::accepted },
+        { "rejec", message_state::rejected },
+        { "enrou", message_state::enroute },
+        { "unkno", message_state::unknown },
+    };
+
+    if(stat.size() < 5)
+        return std::nullopt;
+
+    for(const auto& [prefix, state] : prefixes)
+    {
+        if(std::equal(
+               prefix.begin(),
+               prefix.end(),
+               stat.begin(),
+               [](char a, char b) { return a == to_lower(b); }))
+            return state;
+    }
+
+    return std::nullopt;
+}
+
+inline constexpr std::string_view
+format_receipt_state(message_state state) noexcept
+{
+    switch(state)
+    {
+    case message_state::enroute:
+        return "ENROUTE";
+    case message_state::delivered:
+        return "DELIVRD";
+    case message_state::expired:
+        return "EXPIRED";
+    case message_state::deleted:
+        return "DELETED";
+    case message_state::undeliverable:
+        return "UNDELIV";
+    case message_state::accepted:
+        return "ACCEPTD";
+    case message_state::rejected:
+        return "REJECTD";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+// Parses YYMMDDhhmm or YYMMDDhhmmss, years are taken as 20YY
+inline std::chrono::sys_seconds
+parse_receipt_date(std::string_view date) noexcept
+{
+    using namespace std::chrono;
+
+    if(date.size() != 10 && date.size() != 12)
+        return {};
+
+    int fields[6] = {};
+    for(auto i = std::size_t{}; i < date.size(); i++)
+    {
+        if(date[i] < '0' || date[i] > '9')
+            return {};
+        fields[i / 2] = fields[i / 2] * 10 + (date[i] - '0');
+    }
+
+    const auto ymd = year{ 2000 + fields[0] } / fields[1] / fields[2];
+    if(!ymd.ok() || fields[3] > 23 || fields[4] > 59 || fields[5] > 59)
+        return {};
+
+    return sys_days{ ymd } + hours{ fields[3] } + minutes{ fields[4] } +
+        seconds{ fields[5] };
+}
+
+inline char*
+format_receipt_date(std::chrono::sys_seconds time, char* out) noexcept
+{
+    using namespace std::chrono;
+
+    const auto days = floor<std::chrono::days>(time);
+    const auto ymd  = year_month_day{ days };
+    const auto hms  = hh_mm_ss{ time - days };
+
+    const int fields[5] = { static_cast<int>(ymd.year()) % 100,
+                            static_cast<int>(unsigned{ ymd.month() }),
+                            static_cast<int>(unsigned{ ymd.day() }),
+                            static_cast<int>(hms.hours().count()),
+                            static_cast<int>(hms.minutes().count()) };
+
+    for(auto field : fields)
+    {
+        *out++ = static_cast<char>('0' + field / 10);
+        *out++ = static_cast<char>('0' + field % 10);
+    }
+    return out;
+}
+
+inline char*
+format_receipt_number(uint32_t number, char* out) noexcept
+{
+    // at least three digits, like 001
+    auto buf = std::array<char, 10>{};
+    const auto end =
+        std::to_chars(buf.data(), buf.data() + buf.size(), number).ptr;
+    const auto size = static_cast<std::size_t>(end - buf.data());
+    for(auto i = size; i < 3; i++)
+        *out++ = '0';
+    return std::copy(buf.data(), end, out);
+}
+} // namespace detail
+
+/// Parse the text of a delivery receipt
+/**
+ * The parser is a single pass over the text and doesn't allocate. Keys are
+ * matched case-insensitively and with or without spaces and underscores,
+ * fields may be missing or in any order, and the text field takes the rest
+ * of the message. Unknown fields are skipped.
+ *
+ * @return The receipt, or std::nullopt if the text has no id field.
+ *
+ * @param text The short message of the delivery receipt
+ */
+inline std::optional<delivery_receipt>
+parse_delivery_receipt(std::string_view text) noexcept
+{
+    auto receipt = delivery_receipt{};
+    auto has_id  = false;
+
+    auto number = [](std::string_view value)
+    {
+        auto result = uint32_t{};
+        std::from_chars(value.data(), value.data() + value.size(), result);
+        return result;
+    };
+
+    auto pos = std::size_t{};
+    while(pos < text.size())
+    {
+        while(pos < text.size() && text[pos] == ' ')
+            pos++;
+
+        const auto colon = text.find(':', pos);
+        if(colon == std::string_view::npos)
+            break;
+
+        const auto key = text.substr(pos, colon - pos);
+        pos            = colon + 1;
+
+        if(detail::receipt_key_equals(key, "text"))
+        {
+            receipt.text = text.substr(pos);
+            break;
+        }
+
+        const auto end   = std::min(text.find(' ', pos), text.size());
+        const auto value = text.substr(pos, end - pos);
+        pos              = end;
+
+        if(detail::receipt_key_equals(key, "id"))
+        {
+            receipt.id = value;
+            has_id     = true;
+        }
+        else if(detail::receipt_key_equals(key, "sub"))
+            receipt.submitted = number(value);
+        else if(detail::receipt_key_equals(key, "dlvrd"))
+            receipt.delivered = number(value);
+        else if(detail::receipt_key_equals(key, "submitdate"))
+            receipt.submit_date = detail::parse_receipt_date(value);
+        else if(detail::receipt_key_equals(key, "donedate"))
+            receipt.done_date = detail::parse_receipt_date(value);
+        else if(detail::receipt_key_equals(key, "stat"))
+            receipt.state = detail::parse_receipt_state(value);
+        else if(detail::receipt_key_equals(key, "err"))
+            receipt.error = value;
+    }
+
+    if(!has_id)
+        return std::nullopt;
+
+    return receipt;
+}
+
+/// Parse the delivery receipt of a deliver_sm or data_sm
+/**
+ * The receipted_message_id and message_state optional parameters are
+ * preferred over the id and stat fields of the text when they are present.
+ * The text is the short_message, or the message_payload if the short_message
+ * is empty.
+ *
+ * @return The receipt, or std::nullopt if the PDU has neither an id field
+ * nor a receipted_message_id.
+ *
+ * @param pdu The PDU, it should outlive the receipt
+ */
+template<typename Pdu>
+    requires requires(const Pdu& pdu) { pdu.oparam; }
+std::optional<delivery_receipt>
+parse_delivery_receipt(const Pdu& pdu)
+{
+    auto text = std::string_view{};
+    if constexpr(requires { pdu.short_message; })
+        text = pdu.short_message;
+    if(text.empty() && pdu.oparam.contains(oparam_tag::message_payload))
+        text = pdu.oparam.get_as_string(oparam_tag::message_payload);
+
+    auto receipt = parse_delivery_receipt(text);
+
+    if(pdu.oparam.contains(oparam_tag::receipted_message_id))
+    {
+        if(!receipt)
+            receipt.emplace();
+
+        // it is a C-Octet String, with a NULL terminator on the wire
+        auto id = std::string_view{ pdu.oparam.get_as_string(
+            oparam_tag::receipted_message_id) };
+        if(!id.empty() && id.back() == '\0')
+            id.remove_suffix(1);
+        receipt->id = id;
+    }
+
+    if(receipt && pdu.oparam.contains(oparam_tag::message_state))
+        receipt->state = pdu.oparam.template get_as_enum_u8<message_state>(
+            oparam_tag::message_state);
+
+    return receipt;
+}
+
+/// Format the text of a delivery receipt
+/**
+ * The text has the format of Appendix B of SMPP 3.4:
+ * @code id:IIIIIIIIII sub:SSS dlvrd:DDD submit date:YYMMDDhhmm
+ * done date:YYMMDDhhmm stat:DDDDDDD err:E text:... @endcode
+ * The id is truncated to 65 characters, err to 3 characters and text to 20
+ * characters.
+ *
+ * @return The number of characters written.
+ *
+ * @param receipt The receipt
+ * @param out The output buffer, it should have room for
+ * max_delivery_receipt_size characters
+ */
+inline std::size_t
+format_delivery_receipt(const delivery_receipt& receipt, char* out) noexcept
+{
+    const auto begin = out;
+
+    auto append = [&](std::string_view s, std::size_t max_size)
+    {
+        out = std::copy_n(s.data(), std::min(s.size(), max_size), out);
+    };
+
+    append("id:", 3);
+    append(receipt.id, 65);
+    append(" sub:", 5);
+    out = detail::format_receipt_number(receipt.submitted % 1000, out);
+    append(" dlvrd:", 7);
+    out = detail::format_receipt_number(receipt.delivered % 1000, out);
+    append(" submit date:", 13);
+    out = detail::format_receipt_date(receipt.submit_date, out);
+    append(" done date:", 11);
+    out = detail::format_receipt_date(receipt.done_date, out);
+    append(" stat:", 6);
+    append(
+        detail::format_receipt_state(
+            receipt.state.value_or(message_state::unknown)),
+        7);
+    append(" err:", 5);
+    append(receipt.error.empty() ? "000" : receipt.error, 3);
+    append(" text:", 6);
+    append(receipt.text, 20);
+
+    return static_cast<std::size_t>(out - begin);
+}
+} // namespace smpp
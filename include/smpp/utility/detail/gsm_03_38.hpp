@@ -0,0 +1,300 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/utility/gsm_national_language.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <utility>
+
+namespace smpp::detail
+{
+using gsm_table = std::array<char16_t, 128>;
+
+// Locking shift tables replace the alphabet, single shift tables replace the
+// extension table, zero means not defined. Index 0x1B of alphabets is the
+// escape to the extension table.
+
+// GSM 03.38 default alphabet
+inline constexpr gsm_table gsm_default_alphabet = {
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x00E8, 0x00E9, 0x00F9, 0x00EC,
+    0x00F2, 0x00E7, 0x000A, 0x00D8, 0x00F8, 0x000D, 0x00C5, 0x00E5,
+    0x0394, 0x005F, 0x03A6, 0x0393, 0x039B, 0x03A9, 0x03A0, 0x03A8,
+    0x03A3, 0x0398, 0x039E, 0x00A0, 0x00C6, 0x00E6, 0x00DF, 0x00C9,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00A4, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x00A1, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x00C4, 0x00D6, 0x00D1, 0x00DC, 0x00A7,
+    0x00BF, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x00E4, 0x00F6, 0x00F1, 0x00FC, 0x00E0
+};
+
+// GSM 03.38 default alphabet extension table
+inline constexpr gsm_table gsm_default_extension = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x000C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005E, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x007B, 0x007D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x005C,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005B, 0x007E, 0x005D, 0x0000,
+    0x007C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x20AC, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+
+// 3GPP TS 23.038 A.3.1 Turkish locking shift table
+inline constexpr gsm_table gsm_turkish_locking_shift = {
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x20AC, 0x00E9, 0x00F9, 0x0131,
+    0x00F2, 0x00C7, 0x000A, 0x011E, 0x011F, 0x000D, 0x00C5, 0x00E5,
+    0x0394, 0x005F, 0x03A6, 0x0393, 0x039B, 0x03A9, 0x03A0, 0x03A8,
+    0x03A3, 0x0398, 0x039E, 0x00A0, 0x015E, 0x015F, 0x00DF, 0x00C9,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00A4, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x0130, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x00C4, 0x00D6, 0x00D1, 0x00DC, 0x00A7,
+    0x00E7, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x00E4, 0x00F6, 0x00F1, 0x00FC, 0x00E0
+};
+
+// 3GPP TS 23.038 A.2.1 Turkish single shift table
+inline constexpr gsm_table gsm_turkish_single_shift = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x000C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005E, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x007B, 0x007D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x005C,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005B, 0x007E, 0x005D, 0x0000,
+    0x007C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x011E,
+    0x0000, 0x0130, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x015E, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x00E7, 0x0000, 0x20AC, 0x0000, 0x011F,
+    0x0000, 0x0131, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x015F, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+
+// 3GPP TS 23.038 A.2.2 Spanish single shift table
+inline constexpr gsm_table gsm_spanish_single_shift = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x00E7, 0x000C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005E, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x007B, 0x007D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x005C,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005B, 0x007E, 0x005D, 0x0000,
+    0x007C, 0x00C1, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x00CD, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00D3,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00DA, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x00E1, 0x0000, 0x0000, 0x0000, 0x20AC, 0x0000, 0x0000,
+    0x0000, 0x00ED, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00F3,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00FA, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+
+// 3GPP TS 23.038 A.3.3 Portuguese locking shift table
+inline constexpr gsm_table gsm_portuguese_locking_shift = {
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x00EA, 0x00E9, 0x00FA, 0x00ED,
+    0x00F3, 0x00E7, 0x000A, 0x00D4, 0x00F4, 0x000D, 0x00C1, 0x00E1,
+    0x0394, 0x005F, 0x00AA, 0x00C7, 0x00C0, 0x221E, 0x005E, 0x005C,
+    0x20AC, 0x00D3, 0x007C, 0x00A0, 0x00C2, 0x00E2, 0x00CA, 0x00C9,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00BA, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x00CD, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x00C3, 0x00D5, 0x00DA, 0x00DC, 0x00A7,
+    0x007E, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x00E3, 0x00F5, 0x0060, 0x00FC, 0x00E0
+};
+
+// 3GPP TS 23.038 A.2.3 Portuguese single shift table
+inline constexpr gsm_table gsm_portuguese_single_shift = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00EA, 0x0000, 0x0000,
+    0x0000, 0x00E7, 0x000C, 0x00D4, 0x00F4, 0x0000, 0x00C1, 0x00E1,
+    0x0000, 0x0000, 0x03A6, 0x0393, 0x005E, 0x03A9, 0x03A0, 0x03A8,
+    0x03A3, 0x0398, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00CA,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x007B, 0x007D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x005C,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x005B, 0x007E, 0x005D, 0x0000,
+    0x007C, 0x00C0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x00CD, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00D3,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00DA, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x00C3, 0x00D5, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x00C2, 0x0000, 0x0000, 0x0000, 0x20AC, 0x0000, 0x0000,
+    0x0000, 0x00ED, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00F3,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00FA, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x00E3, 0x00F5, 0x0000, 0x0000, 0x00E2
+};
+
+inline constexpr uint8_t gsm_escape = 0x1B;
+
+inline constexpr uint16_t gsm_not_found = 0xFFFF;
+
+inline constexpr const gsm_table&
+gsm_locking_shift_table(gsm_national_language language) noexcept
+{
+    switch(language)
+    {
+    case gsm_national_language::turkish:
+        return gsm_turkish_locking_shift;
+    case gsm_national_language::portuguese:
+        return gsm_portuguese_locking_shift;
+    default:
+        return gsm_default_alphabet;
+    }
+}
+
+inline constexpr const gsm_table&
+gsm_single_shift_table(gsm_national_language language) noexcept
+{
+    switch(language)
+    {
+    case gsm_national_language::turkish:
+        return gsm_turkish_single_shift;
+    case gsm_national_language::spanish:
+        return gsm_spanish_single_shift;
+    case gsm_national_language::portuguese:
+        return gsm_portuguese_single_shift;
+    default:
+        return gsm_default_extension;
+    }
+}
+
+// Lookup of a code point in a pair of tables, returns the septet, or the
+// septet of the extension table ORed with 0x1B00, or gsm_not_found.
+inline constexpr uint16_t
+find_gsm_septet(
+    const gsm_table& alphabet,
+    const gsm_table& extension,
+    char32_t cp) noexcept
+{
+    if(cp == 0 || cp > 0xFFFF)
+        return gsm_not_found;
+
+    for(auto i = 0; i < 128; i++)
+        if(alphabet[i] == cp && i != gsm_escape)
+            return static_cast<uint16_t>(i);
+
+    for(auto i = 0; i < 128; i++)
+        if(extension[i] == cp)
+            return static_cast<uint16_t>(gsm_escape << 8 | i);
+
+    return gsm_not_found;
+}
+
+// Reverse lookup of a table pair, sorted by code point
+using gsm_index = std::array<std::pair<char16_t, uint16_t>, 256>;
+
+inline constexpr gsm_index
+make_gsm_index(const gsm_table& alphabet, const gsm_table& extension)
+{
+    auto index = gsm_index{};
+    for(auto i = 0; i < 128; i++)
+    {
+        index[i] = { i == gsm_escape ? char16_t{} : alphabet[i],
+                      static_cast<uint16_t>(i) };
+        index[128 + i] = { extension[i],
+                            static_cast<uint16_t>(gsm_escape << 8 | i) };
+    }
+    // the alphabet wins over the extension table for duplicates, as its
+    // septets are smaller
+    std::sort(index.begin(), index.end());
+    return index;
+}
+
+inline constexpr uint16_t
+find_gsm_septet(const gsm_index& index, char32_t cp) noexcept
+{
+    if(cp == 0 || cp > 0xFFFF)
+        return gsm_not_found;
+
+    const auto it = std::lower_bound(
+        index.begin(),
+        index.end(),
+        cp,
+        [](const auto& e, char32_t cp) { return e.first < cp; });
+
+    if(it != index.end() && it->first == cp)
+        return it->second;
+
+    return gsm_not_found;
+}
+
+// Precomputed lookup of the default alphabet for the first 256 code points
+inline constexpr auto gsm_default_latin1 = []
+{
+    auto table = std::array<uint16_t, 256>{};
+    for(auto cp = 0; cp < 256; cp++)
+        table[cp] = find_gsm_septet(
+            gsm_default_alphabet, gsm_default_extension, char32_t(cp));
+    return table;
+}();
+
+inline constexpr uint16_t
+find_gsm_default_septet(char32_t cp) noexcept
+{
+    if(cp < 256)
+        return gsm_default_latin1[cp];
+    return find_gsm_septet(gsm_default_alphabet, gsm_default_extension, cp);
+}
+
+// Reverse lookups of all the supported table pairs, by locking shift and
+// single shift national language identifiers
+inline constexpr auto gsm_indices = []
+{
+    auto indices = std::array<std::array<gsm_index, 4>, 4>{};
+    for(auto l = 0; l < 4; l++)
+        for(auto s = 0; s < 4; s++)
+            indices[l][s] = make_gsm_index(
+                gsm_locking_shift_table(static_cast<gsm_national_language>(l)),
+                gsm_single_shift_table(static_cast<gsm_national_language>(s)));
+    return indices;
+}();
+
+inline constexpr uint16_t
+find_gsm_septet(const gsm_alphabet& alphabet, char32_t cp) noexcept
+{
+    if(alphabet == gsm_alphabet{})
+        return find_gsm_default_septet(cp);
+
+    const auto l = static_cast<std::size_t>(alphabet.locking_shift);
+    const auto s = static_cast<std::size_t>(alphabet.single_shift);
+    if(l >= gsm_indices.size() || s >= gsm_indices.size())
+        return gsm_not_found;
+
+    return find_gsm_septet(gsm_indices[l][s], cp);
+}
+} // namespace smpp::detail
@@ -0,0 +1,55 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace smpp::detail
+{
+struct transliteration
+{
+    char32_t cp;
+    std::string_view replacement;
+};
+
+// Replacements made of GSM 03.38 default alphabet characters, sorted by code
+// point
+inline constexpr std::array<transliteration, 62> transliterations = { {
+    { 0x00A0, " " },   { 0x00A2, "c" },   { 0x00A6, "|" },   { 0x00A8, "\"" },
+    { 0x00A9, "(C)" }, { 0x00AB, "\"" },  { 0x00AD, "-" },   { 0x00AE, "(R)" },
+    { 0x00B4, "'" },   { 0x00B7, "." },   { 0x00BB, "\"" },  { 0x00C0, "A" },
+    { 0x00C1, "A" },   { 0x00C2, "A" },   { 0x00C3, "A" },   { 0x00C8, "E" },
+    { 0x00CA, "E" },   { 0x00CB, "E" },   { 0x00CC, "I" },   { 0x00CD, "I" },
+    { 0x00CE, "I" },   { 0x00CF, "I" },   { 0x00D2, "O" },   { 0x00D3, "O" },
+    { 0x00D4, "O" },   { 0x00D5, "O" },   { 0x00D7, "x" },   { 0x00D9, "U" },
+    { 0x00DA, "U" },   { 0x00DB, "U" },   { 0x00DD, "Y" },   { 0x00E1, "a" },
+    { 0x00E2, "a" },   { 0x00E3, "a" },   { 0x00EA, "e" },   { 0x00EB, "e" },
+    { 0x00ED, "i" },   { 0x00EE, "i" },   { 0x00EF, "i" },   { 0x00F3, "o" },
+    { 0x00F4, "o" },   { 0x00F5, "o" },   { 0x00F7, "/" },   { 0x00FA, "u" },
+    { 0x00FB, "u" },   { 0x00FD, "y" },   { 0x00FF, "y" },   { 0x2010, "-" },
+    { 0x2011, "-" },   { 0x2012, "-" },   { 0x2013, "-" },   { 0x2014, "-" },
+    { 0x2018, "'" },   { 0x2019, "'" },   { 0x201A, "'" },   { 0x201B, "'" },
+    { 0x201C, "\"" },  { 0x201D, "\"" },  { 0x201E, "\"" },  { 0x2022, "-" },
+    { 0x2026, "..." }, { 0x2122, "TM" },
+} };
+
+// Returns an empty string_view if there is no transliteration
+inline constexpr std::string_view
+find_transliteration(char32_t cp) noexcept
+{
+    const auto it = std::lower_bound(
+        transliterations.begin(),
+        transliterations.end(),
+        cp,
+        [](const transliteration& t, char32_t cp) { return t.cp < cp; });
+
+    if(it != transliterations.end() && it->cp == cp)
+        return it->replacement;
+
+    return {};
+}
+} // namespace smpp::detail
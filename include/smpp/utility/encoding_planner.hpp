@@ -0,0 +1,223 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/param/data_coding.hpp>
+#include <smpp/utility/unicode_converter.hpp>
+
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace smpp
+{
+struct encoding_plan
+{
+    // The data_coding that the text should be sent with
+    smpp::data_coding data_coding{ data_coding::defaults };
+
+    // Encoded length, in septets for GSM 7-bit and in octets otherwise
+    std::size_t length{};
+
+    // Number of segments when a concatenation UDH is used
+    std::size_t segments{};
+
+    // Number of segments when no concatenation UDH is used, like with sar_*
+    // TLVs
+    std::size_t segments_without_udh{};
+
+    // The national language tables of GSM 7-bit, they should be signalled in
+    // the user data header, see user_data_header::set_gsm_alphabet
+    gsm_alphabet alphabet{};
+
+    bool
+    operator==(const encoding_plan&) const = default;
+};
+
+struct encoding_options
+{
+    // Replace characters that are not in GSM 03.38 with similar ones that are
+    bool transliterate{ false };
+
+    // Use ISO 8859-1 for texts that don't fit GSM 03.38 but fit ISO 8859-1
+    bool allow_latin1{ true };
+
+    // National language whose shift tables can be used for GSM 7-bit
+    gsm_national_language national_language{ gsm_national_language::none };
+};
+
+namespace detail
+{
+class segment_counter
+{
+    std::size_t single_;
+    std::size_t concatenated_;
+    std::size_t length_{};
+    std::size_t with_udh_{ 1 };
+    std::size_t with_udh_used_{};
+    std::size_t without_udh_{ 1 };
+    std::size_t without_udh_used_{};
+
+public:
+    constexpr segment_counter(std::size_t single, std::size_t concatenated)
+        : single_{ single }
+        , concatenated_{ concatenated }
+    {
+    }
+
+    // A unit is never split between segments, like an escaped GSM character
+    // or a UTF-16 surrogate pair
+    constexpr void
+    add(std::size_t unit)
+    {
+        length_ += unit;
+
+        if(with_udh_used_ + unit > concatenated_)
+        {
+            with_udh_++;
+            with_udh_used_ = 0;
+        }
+        with_udh_used_ += unit;
+
+        if(without_udh_used_ + unit > single_)
+        {
+            without_udh_++;
+            without_udh_used_ = 0;
+        }
+        without_udh_used_ += unit;
+    }
+
+    constexpr encoding_plan
+    plan(smpp::data_coding data_coding, std::size_t octets_per_unit) const
+    {
+        return { data_coding,
+                 length_ * octets_per_unit,
+                 length_ <= single_ ? 1 : with_udh_,
+                 without_udh_ };
+    }
+};
+
+// Capacity of a GSM 7-bit segment in septets, for the given information
+// elements in the user data header
+constexpr std::size_t
+gsm_segment_capacity(std::size_t ie_octets) noexcept
+{
+    return ie_octets == 0 ? 160 : (140 - 1 - ie_octets) * 8 / 7;
+}
+
+struct gsm_candidate
+{
+    gsm_alphabet alphabet;
+    segment_counter counter;
+    bool valid{ true };
+
+    explicit constexpr gsm_candidate(gsm_alphabet a)
+        : alphabet{ a }
+        , counter{ 0, 0 }
+    {
+        // each national language IE takes 3 octets and concatenation 5
+        const auto ie_octets =
+            (alphabet.locking_shift != gsm_national_language::none ? 3 : 0) +
+            (alphabet.single_shift != gsm_national_language::none ? 3 : 0);
+        counter = { gsm_segment_capacity(ie_octets),
+                    gsm_segment_capacity(ie_octets + 5) };
+    }
+};
+} // namespace detail
+
+/// Plan the cheapest encoding of a text
+/**
+ * GSM 03.38 7-bit is preferred, with the shift tables of the national
+ * language if they need fewer segments, then ISO 8859-1 and then UCS-2. The
+ * segment counts never split an escaped GSM character or a UTF-16 surrogate
+ * pair. Throws std::invalid_argument on invalid UTF-8.
+ *
+ * @param utf8 The UTF-8 text
+ * @param options The encoding options
+ */
+inline encoding_plan
+plan_encoding(std::string_view utf8, encoding_options options = {})
+{
+    using enum gsm_national_language;
+
+    // the default alphabet and the shift tables of the national language
+    const auto language = options.national_language;
+    auto gsm            = std::array<detail::gsm_candidate, 4>{
+        detail::gsm_candidate{ { none, none } },
+        detail::gsm_candidate{ { none, language } },
+        detail::gsm_candidate{ { language, none } },
+        detail::gsm_candidate{ { language, language } }
+    };
+    gsm[1].valid = language != none;
+    gsm[2].valid = language != none && language != spanish;
+    gsm[3].valid = gsm[2].valid;
+
+    // capacities in octets and UTF-16 code units
+    auto latin1    = detail::segment_counter{ 140, 134 };
+    auto ucs2      = detail::segment_counter{ 70, 67 };
+    auto is_latin1 = options.allow_latin1;
+
+    auto add_gsm = [](detail::gsm_candidate& c, char32_t cp)
+    {
+        const auto septet = detail::find_gsm_septet(c.alphabet, cp);
+        if(septet == detail::gsm_not_found)
+            return false;
+        c.counter.add(septet > 0xFF ? 2 : 1);
+        return true;
+    };
+
+    const auto* p   = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* end = p + utf8.size();
+    while(p != end)
+    {
+        const auto cp = detail::decode_utf8(p, end);
+
+        for(auto& c : gsm)
+        {
+            if(!c.valid || add_gsm(c, cp))
+                continue;
+
+            const auto replacement = options.transliterate
+                ? detail::find_transliteration(cp)
+                : std::string_view{};
+            for(auto r : replacement)
+                add_gsm(c, static_cast<char32_t>(r));
+            c.valid = !replacement.empty();
+        }
+
+        if(is_latin1)
+        {
+            if(cp <= 0xFF)
+                latin1.add(1);
+            else
+                is_latin1 = false;
+        }
+
+        ucs2.add(cp >= 0x10000 ? 2 : 1);
+    }
+
+    // the fewest segments, with the fewest shift tables for ties
+    auto best = std::optional<encoding_plan>{};
+    for(const auto& c : gsm)
+    {
+        if(!c.valid)
+            continue;
+        auto plan     = c.counter.plan(data_coding::defaults, 1);
+        plan.alphabet = c.alphabet;
+        if(!best || plan.segments < best->segments)
+            best = plan;
+    }
+
+    if(best)
+        return *best;
+
+    if(is_latin1)
+        return latin1.plan(data_coding::iso8859_1, 1);
+
+    return ucs2.plan(data_coding::ucs2, 2);
+}
+} // namespace smpp
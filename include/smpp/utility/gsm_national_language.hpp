@@ -0,0 +1,33 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cinttypes>
+
+namespace smpp
+{
+// National language identifiers of 3GPP TS 23.038, the Indic languages
+// (0x04 - 0x0D) are deferred until their tables can be verified against test
+// vectors, texts in these scripts are encoded as UCS-2
+enum class gsm_national_language : uint8_t
+{
+    none       = 0x00, // GSM 03.38 default alphabet and extension table
+    turkish    = 0x01,
+    spanish    = 0x02, // only has a single shift table
+    portuguese = 0x03
+};
+
+struct gsm_alphabet
+{
+    // The table that replaces the default alphabet
+    gsm_national_language locking_shift{ gsm_national_language::none };
+
+    // The table that replaces the default extension table
+    gsm_national_language single_shift{ gsm_national_language::none };
+
+    bool
+    operator==(const gsm_alphabet&) const = default;
+};
+} // namespace smpp
@@ -0,0 +1,384 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SMPP_GSM_SEPTET_SSE2
+#if defined(__GNUC__)
+#include <immintrin.h>
+#define SMPP_GSM_SEPTET_AVX2
+#endif
+#endif
+
+namespace smpp
+{
+namespace detail
+{
+// A group of 8 septets, one per octet, is packed into the lower 56 bits of a
+// 64-bit word by three rounds of shifting and merging neighbouring fields.
+
+inline void
+pack_septet_groups_scalar(uint64_t* v, std::size_t n) noexcept
+{
+    for(auto i = std::size_t{}; i < n; i++)
+    {
+        auto x = v[i] & 0x7F7F7F7F7F7F7F7F;
+        x      = (x & 0x007F007F007F007F) | ((x & 0x7F007F007F007F00) >> 1);
+        x      = (x & 0x00003FFF00003FFF) | ((x & 0x3FFF00003FFF0000) >> 2);
+        x      = (x & 0x000000000FFFFFFF) | ((x & 0x0FFFFFFF00000000) >> 4);
+        v[i]   = x;
+    }
+}
+
+inline void
+unpack_septet_groups_scalar(uint64_t* v, std::size_t n) noexcept
+{
+    for(auto i = std::size_t{}; i < n; i++)
+    {
+        auto x = v[i] & 0x00FFFFFFFFFFFFFF;
+        x      = (x & 0x000000000FFFFFFF) | ((x & 0x00FFFFFFF0000000) << 4);
+        x      = (x & 0x00003FFF00003FFF) | ((x & 0x0FFFC0000FFFC000) << 2);
+        x      = (x & 0x007F007F007F007F) | ((x & 0x3F803F803F803F80) << 1);
+        v[i]   = x;
+    }
+}
+
+#if defined(SMPP_GSM_SEPTET_SSE2)
+inline void
+pack_septet_groups_sse2(uint64_t* v, std::size_t n) noexcept
+{
+    const auto m0  = _mm_set1_epi64x(0x7F7F7F7F7F7F7F7F);
+    const auto m1l = _mm_set1_epi64x(0x007F007F007F007F);
+    const auto m1h = _mm_set1_epi64x(0x7F007F007F007F00);
+    const auto m2l = _mm_set1_epi64x(0x00003FFF00003FFF);
+    const auto m2h = _mm_set1_epi64x(0x3FFF00003FFF0000);
+    const auto m3l = _mm_set1_epi64x(0x000000000FFFFFFF);
+    const auto m3h = _mm_set1_epi64x(0x0FFFFFFF00000000);
+
+    auto i = std::size_t{};
+    for(; i + 2 <= n; i += 2)
+    {
+        auto* p = reinterpret_cast<__m128i*>(v + i);
+        auto x  = _mm_and_si128(_mm_loadu_si128(p), m0);
+        x       = _mm_or_si128(
+            _mm_and_si128(x, m1l), _mm_srli_epi64(_mm_and_si128(x, m1h), 1));
+        x = _mm_or_si128(
+            _mm_and_si128(x, m2l), _mm_srli_epi64(_mm_and_si128(x, m2h), 2));
+        x = _mm_or_si128(
+            _mm_and_si128(x, m3l), _mm_srli_epi64(_mm_and_si128(x, m3h), 4));
+        _mm_storeu_si128(p, x);
+    }
+    pack_septet_groups_scalar(v + i, n - i);
+}
+
+inline void
+unpack_septet_groups_sse2(uint64_t* v, std::size_t n) noexcept
+{
+    const auto m0  = _mm_set1_epi64x(0x00FFFFFFFFFFFFFF);
+    const auto m1l = _mm_set1_epi64x(0x000000000FFFFFFF);
+    const auto m1h = _mm_set1_epi64x(0x00FFFFFFF0000000);
+    const auto m2l = _mm_set1_epi64x(0x00003FFF00003FFF);
+    const auto m2h = _mm_set1_epi64x(0x0FFFC0000FFFC000);
+    const auto m3l = _mm_set1_epi64x(0x007F007F007F007F);
+    const auto m3h = _mm_set1_epi64x(0x3F803F803F803F80);
+
+    auto i = std::size_t{};
+    for(; i + 2 <= n; i += 2)
+    {
+        auto* p = reinterpret_cast<__m128i*>(v + i);
+        auto x  = _mm_and_si128(_mm_loadu_si128(p), m0);
+        x       = _mm_or_si128(
+            _mm_and_si128(x, m1l), _mm_slli_epi64(_mm_and_si128(x, m1h), 4));
+        x = _mm_or_si128(
+            _mm_and_si128(x, m2l), _mm_slli_epi64(_mm_and_si128(x, m2h), 2));
+        x = _mm_or_si128(
+            _mm_and_si128(x, m3l), _mm_slli_epi64(_mm_and_si128(x, m3h), 1));
+        _mm_storeu_si128(p, x);
+    }
+    unpack_septet_groups_scalar(v + i, n - i);
+}
+#endif
+
+#if defined(SMPP_GSM_SEPTET_AVX2)
+__attribute__((target("avx2"))) inline void
+pack_septet_groups_avx2(uint64_t* v, std::size_t n) noexcept
+{
+    const auto m0  = _mm256_set1_epi64x(0x7F7F7F7F7F7F7F7F);
+    const auto m1l = _mm256_set1_epi64x(0x007F007F007F007F);
+    const auto m1h = _mm256_set1_epi64x(0x7F007F007F007F00);
+    const auto m2l = _mm256_set1_epi64x(0x00003FFF00003FFF);
+    const auto m2h = _mm256_set1_epi64x(0x3FFF00003FFF0000);
+    const auto m3l = _mm256_set1_epi64x(0x000000000FFFFFFF);
+    const auto m3h = _mm256_set1_epi64x(0x0FFFFFFF00000000);
+
+    auto i = std::size_t{};
+    for(; i + 4 <= n; i += 4)
+    {
+        auto* p = reinterpret_cast<__m256i*>(v + i);
+        auto x  = _mm256_and_si256(_mm256_loadu_si256(p), m0);
+        x       = _mm256_or_si256(
+            _mm256_and_si256(x, m1l),
+            _mm256_srli_epi64(_mm256_and_si256(x, m1h), 1));
+        x = _mm256_or_si256(
+            _mm256_and_si256(x, m2l),
+            _mm256_srli_epi64(_mm256_and_si256(x, m2h), 2));
+        x = _mm256_or_si256(
+            _mm256_and_si256(x, m3l),
+            _mm256_srli_epi64(_mm256_and_si256(x, m3h), 4));
+        _mm256_storeu_si256(p, x);
+    }
+    pack_septet_groups_sse2(v + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline void
+unpack_septet_groups_avx2(uint64_t* v, std::size_t n) noexcept
+{
+    const auto m0  = _mm256_set1_epi64x(0x00FFFFFFFFFFFFFF);
+    const auto m1l = _mm256_set1_epi64x(0x000000000FFFFFFF);
+    const auto m1h = _mm256_set1_epi64x(0x00FFFFFFF0000000);
+    const auto m2l = _mm256_set1_epi64x(0x00003FFF00003FFF);
+    const auto m2h = _mm256_set1_epi64x(0x0FFFC0000FFFC000);
+    const auto m3l = _mm256_set1_epi64x(0x007F007F007F007F);
+    const auto m3h = _mm256_set1_epi64x(0x3F803F803F803F80);
+
+    auto i = std::size_t{};
+    for(; i + 4 <= n; i += 4)
+    {
+        auto* p = reinterpret_cast<__m256i*>(v + i);
+        auto x  = _mm256_and_si256(_mm256_loadu_si256(p), m0);
+        x       = _mm256_or_si256(
+            _mm256_and_si256(x, m1l),
+            _mm256_slli_epi64(_mm256_and_si256(x, m1h), 4));
+        x = _mm256_or_si256(
+            _mm256_and_si256(x, m2l),
+            _mm256_slli_epi64(_mm256_and_si256(x, m2h), 2));
+        x = _mm256_or_si256(
+            _mm256_and_si256(x, m3l),
+            _mm256_slli_epi64(_mm256_and_si256(x, m3h), 1));
+        _mm256_storeu_si256(p, x);
+    }
+    unpack_septet_groups_sse2(v + i, n - i);
+}
+#endif
+
+using septet_groups_kernel = void (*)(uint64_t*, std::size_t) noexcept;
+
+struct septet_kernels
+{
+    septet_groups_kernel pack;
+    septet_groups_kernel unpack;
+};
+
+inline septet_kernels
+select_septet_kernels() noexcept
+{
+#if defined(SMPP_GSM_SEPTET_AVX2)
+    if(__builtin_cpu_supports("avx2"))
+        return { pack_septet_groups_avx2, unpack_septet_groups_avx2 };
+#endif
+#if defined(SMPP_GSM_SEPTET_SSE2)
+    return { pack_septet_groups_sse2, unpack_septet_groups_sse2 };
+#else
+    return { pack_septet_groups_scalar, unpack_septet_groups_scalar };
+#endif
+}
+
+inline const septet_kernels&
+septet_kernels_instance() noexcept
+{
+    static const auto kernels = select_septet_kernels();
+    return kernels;
+}
+
+inline uint64_t
+load_u64_le(const char* p, std::size_t size) noexcept
+{
+    auto v = uint64_t{};
+    for(auto i = std::size_t{}; i < std::min<std::size_t>(size, 8); i++)
+        v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+    return v;
+}
+
+inline void
+store_u64_le(char* p, uint64_t v, std::size_t size) noexcept
+{
+    for(auto i = std::size_t{}; i < size; i++)
+        p[i] = static_cast<char>(static_cast<uint8_t>(v >> (8 * i)));
+}
+} // namespace detail
+
+/// Return the number of fill bits needed after a user data header
+/**
+ * The septets of a GSM 7-bit message that has a user data header start on a
+ * septet boundary, so enough fill bits are inserted after the header.
+ *
+ * @param udh_length The length of the user data header in octets, including
+ * the UDHL octet itself.
+ */
+constexpr uint8_t
+udh_fill_bits(std::size_t udh_length) noexcept
+{
+    return static_cast<uint8_t>((7 - (udh_length * 8) % 7) % 7);
+}
+
+/// Return the number of octets that septets would be packed into
+constexpr std::size_t
+packed_septets_size(std::size_t septets, uint8_t fill_bits = 0) noexcept
+{
+    return (septets * 7 + fill_bits + 7) / 8;
+}
+
+/// Return the maximum number of septets that octets can contain
+constexpr std::size_t
+unpacked_septets_size(std::size_t octets, uint8_t fill_bits = 0) noexcept
+{
+    return octets * 8 < fill_bits ? 0 : (octets * 8 - fill_bits) / 7;
+}
+
+/// Pack GSM 03.38 septets into octets
+/**
+ * Each input octet holds one septet, the most significant bit is ignored. The
+ * output starts with fill_bits zero bits.
+ *
+ * @return The number of octets written, which is
+ * packed_septets_size(septets.size(), fill_bits).
+ *
+ * @param septets The unpacked septets
+ * @param out The output buffer, it should have room for
+ * packed_septets_size(septets.size(), fill_bits) octets
+ * @param fill_bits The number of fill bits, in range [0, 6]
+ */
+inline std::size_t
+pack_septets(std::string_view septets, char* out, uint8_t fill_bits = 0)
+{
+    if(fill_bits > 6)
+        throw std::invalid_argument{ "fill_bits is larger than 6" };
+
+    const auto& kernels = detail::septet_kernels_instance();
+    const auto size     = packed_septets_size(septets.size(), fill_bits);
+    auto groups         = std::array<uint64_t, 32>{};
+    auto carry          = uint64_t{};
+    auto pos            = std::size_t{};
+
+    while(!septets.empty())
+    {
+        auto n = std::size_t{};
+        for(; n < groups.size() && !septets.empty(); n++)
+        {
+            groups[n] = detail::load_u64_le(septets.data(), septets.size());
+            septets.remove_prefix(std::min<std::size_t>(septets.size(), 8));
+        }
+
+        kernels.pack(groups.data(), n);
+
+        for(auto i = std::size_t{}; i < n; i++)
+        {
+            const auto w = (groups[i] << fill_bits) | carry;
+            carry        = fill_bits ? groups[i] >> (56 - fill_bits) : 0;
+            const auto c = std::min<std::size_t>(7, size - pos);
+            detail::store_u64_le(out + pos, w, c);
+            pos += c;
+        }
+    }
+
+    if(pos < size)
+        detail::store_u64_le(out + pos, carry, size - pos);
+
+    return size;
+}
+
+/// Pack GSM 03.38 septets into octets
+/**
+ * See the buffer overload of pack_septets.
+ */
+inline std::string
+pack_septets(std::string_view septets, uint8_t fill_bits = 0)
+{
+    auto packed =
+        std::string(packed_septets_size(septets.size(), fill_bits), '\0');
+    pack_septets(septets, packed.data(), fill_bits);
+    return packed;
+}
+
+/// Unpack octets into GSM 03.38 septets
+/**
+ * Each output octet holds one septet.
+ *
+ * @return The number of septets written.
+ *
+ * @param octets The packed octets, starting with fill_bits fill bits
+ * @param out The output buffer, it should have room for septets octets
+ * @param septets The number of septets to unpack
+ * @param fill_bits The number of fill bits, in range [0, 6]
+ */
+inline std::size_t
+unpack_septets(
+    std::string_view octets,
+    char* out,
+    std::size_t septets,
+    uint8_t fill_bits = 0)
+{
+    if(fill_bits > 6)
+        throw std::invalid_argument{ "fill_bits is larger than 6" };
+
+    if(septets > unpacked_septets_size(octets.size(), fill_bits))
+        throw std::length_error{ "septets are larger than available octets" };
+
+    const auto& kernels = detail::septet_kernels_instance();
+    auto groups         = std::array<uint64_t, 32>{};
+    auto pos            = std::size_t{};
+    auto in             = std::size_t{};
+
+    while(pos < septets)
+    {
+        auto n = std::size_t{};
+        for(; n < groups.size() && pos + n * 8 < septets; n++, in += 7)
+        {
+            const auto avail = octets.size() - std::min(octets.size(), in);
+            groups[n] =
+                detail::load_u64_le(octets.data() + in, avail) >> fill_bits;
+        }
+
+        kernels.unpack(groups.data(), n);
+
+        for(auto i = std::size_t{}; i < n; i++)
+        {
+            const auto c = std::min<std::size_t>(8, septets - pos);
+            detail::store_u64_le(out + pos, groups[i], c);
+            pos += c;
+        }
+    }
+
+    return septets;
+}
+
+/// Unpack octets into GSM 03.38 septets
+/**
+ * See the buffer overload of unpack_septets.
+ *
+ * @param octets The packed octets, starting with fill_bits fill bits
+ * @param septets The number of septets to unpack
+ * @param fill_bits The number of fill bits, in range [0, 6]
+ */
+inline std::string
+unpack_septets(
+    std::string_view octets,
+    std::size_t septets,
+    uint8_t fill_bits = 0)
+{
+    auto unpacked = std::string(septets, '\0');
+    unpack_septets(octets, unpacked.data(), septets, fill_bits);
+    return unpacked;
+}
+} // namespace smpp
@@ -0,0 +1,363 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/param/esm_class.hpp>
+#include <smpp/param/oparam.hpp>
+#include <smpp/utility/short_message.hpp>
+
+#include <chrono>
+#include <cinttypes>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace smpp
+{
+struct reassembly_options
+{
+    // The time a message waits for its missing parts before it is evicted
+    std::chrono::milliseconds timeout{ 60000 };
+
+    // Maximum number of incomplete messages
+    std::size_t max_messages{ 65536 };
+
+    // Maximum number of octets of the parts of incomplete messages
+    std::size_t max_bytes{ 64 * 1024 * 1024 };
+};
+
+namespace detail
+{
+struct message_part
+{
+    bool concatenated{ false };
+    uint16_t reference{};
+    uint8_t total{ 1 };
+    uint8_t sequence{ 1 };
+    std::string_view body;
+};
+
+// Finds the concatenation info of a PDU in its UDH or in its SAR TLVs, the
+// body is the user data without the UDH
+template<typename Pdu>
+message_part
+find_message_part(const Pdu& pdu)
+{
+    auto part = message_part{};
+
+    auto message = std::string_view{};
+    if constexpr(requires { pdu.short_message; })
+        message = pdu.short_message;
+    if(message.empty() && pdu.oparam.contains(oparam_tag::message_payload))
+        message = pdu.oparam.get_as_string(oparam_tag::message_payload);
+
+    part.body = message;
+
+    const auto features = pdu.esm_class.gsm_network_features;
+    if(features == gsm_network_features::uhdi ||
+       features == gsm_network_features::both)
+    {
+        if(message.empty() ||
+           static_cast<uint8_t>(message[0]) >= message.size())
+            throw std::length_error{ "UDH length is larger than message" };
+
+        const auto udh_length = static_cast<uint8_t>(message[0]);
+        const auto udh = user_data_header{ message.substr(1, udh_length) };
+        const auto mpd = udh.get_multi_part_data();
+        part.body      = message.substr(1 + udh_length);
+
+        if(mpd.number_of_parts_ != 1)
+        {
+            part.concatenated = true;
+            part.reference    = mpd.concat_sm_ref_num_;
+            part.total        = mpd.number_of_parts_;
+            part.sequence     = mpd.sequence_number_;
+        }
+    }
+
+    if(!part.concatenated && pdu.oparam.contains(oparam_tag::sar_msg_ref_num))
+    {
+        using enum oparam_tag;
+        const auto& ref   = pdu.oparam.get_as_string(sar_msg_ref_num);
+        const auto& total = pdu.oparam.get_as_string(sar_total_segments);
+        const auto& seq   = pdu.oparam.get_as_string(sar_segment_seqnum);
+        if(ref.size() != 2 || total.size() != 1 || seq.size() != 1)
+            throw std::length_error{ "sar optional parameters are invalid" };
+
+        part.concatenated = true;
+        part.reference    = static_cast<uint16_t>(
+            static_cast<uint8_t>(ref[0]) << 8 | static_cast<uint8_t>(ref[1]));
+        part.total    = static_cast<uint8_t>(total[0]);
+        part.sequence = static_cast<uint8_t>(seq[0]);
+    }
+
+    return part;
+}
+} // namespace detail
+
+/// Reassembles concatenated messages from their parts
+/**
+ * Parts are linked by the concatenation IEs of their UDH, 8-bit or 16-bit
+ * reference, or by their SAR optional parameters, and messages are keyed by
+ * source address, destination address and reference number. The incomplete
+ * messages live in a slab of entries that is reused as messages complete, and
+ * the oldest of them are evicted when they time out, or when there are more
+ * of them than max_messages or their parts take more than max_bytes.
+ *
+ * The completion handler is called with the PDU of the first part, with its
+ * UDH intact, and the user data of all parts without their UDH, in order.
+ * Messages that are not concatenated are passed through immediately. The
+ * handler may call add, the completed message is released before it is called.
+ *
+ * @tparam Pdu deliver_sm, submit_sm or data_sm
+ */
+template<typename Pdu>
+class message_reassembler
+{
+public:
+    using clock              = std::chrono::steady_clock;
+    using completion_handler =
+        std::function<void(const Pdu&, std::string_view)>;
+
+private:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    struct message_key
+    {
+        std::string source_addr;
+        std::string dest_addr;
+        uint16_t reference{};
+
+        bool
+        operator==(const message_key&) const = default;
+    };
+
+    struct message_key_hash
+    {
+        std::size_t
+        operator()(const message_key& key) const noexcept
+        {
+            auto hash = std::hash<std::string_view>{}(key.source_addr);
+            hash ^= std::hash<std::string_view>{}(key.dest_addr) +
+                0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+            return hash ^ key.reference;
+        }
+    };
+
+    struct entry
+    {
+        message_key key;
+        Pdu first{};
+        clock::time_point created{};
+        uint8_t total{};
+        uint8_t received{};
+        std::string data;
+        // offset and size of each part in data, size is npos until received
+        std::vector<std::pair<uint32_t, uint32_t>> parts;
+        uint32_t prev{ npos };
+        uint32_t next{ npos };
+    };
+
+    reassembly_options options_;
+    completion_handler handler_;
+    std::vector<entry> slab_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<message_key, uint32_t, message_key_hash> index_;
+    uint32_t head_{ npos };
+    uint32_t tail_{ npos };
+    std::size_t bytes_{};
+    std::size_t evicted_{};
+    message_key lookup_;
+    std::string assembled_;
+
+public:
+    /// Construct a message_reassembler
+    /**
+     * @param handler The handler that completed messages would be passed to
+     * @param options The eviction options
+     */
+    explicit message_reassembler(
+        completion_handler handler,
+        reassembly_options options = {})
+        : options_{ options }
+        , handler_{ std::move(handler) }
+    {
+    }
+
+    /// Add a part
+    /**
+     * Duplicate parts and parts whose sequence number is out of range are
+     * ignored. Throws std::length_error if the UDH or the SAR optional
+     * parameters are malformed.
+     *
+     * @return True if the part has completed a message.
+     *
+     * @param pdu The part
+     * @param now The current time, for eviction
+     */
+    bool
+    add(const Pdu& pdu, clock::time_point now = clock::now())
+    {
+        expire(now);
+
+        const auto part = detail::find_message_part(pdu);
+        if(!part.concatenated || part.total == 1)
+        {
+            handler_(pdu, part.body);
+            return true;
+        }
+
+        if(part.sequence == 0 || part.sequence > part.total)
+            return false;
+
+        lookup_.source_addr.assign(pdu.source_addr);
+        lookup_.dest_addr.assign(pdu.dest_addr);
+        lookup_.reference = part.reference;
+
+        auto it = index_.find(lookup_);
+        if(it != index_.end() && slab_[it->second].total != part.total)
+        {
+            // the reference is reused for another message
+            release(it->second);
+            it = index_.end();
+        }
+        if(it == index_.end())
+            it = index_.emplace(lookup_, allocate(part.total, now)).first;
+
+        const auto index = it->second;
+        auto& e          = slab_[index];
+        auto& slot       = e.parts[part.sequence - 1];
+        if(slot.second != npos)
+            return false;
+
+        slot = { static_cast<uint32_t>(e.data.size()),
+                 static_cast<uint32_t>(part.body.size()) };
+        e.data.append(part.body);
+        bytes_ += part.body.size();
+        if(part.sequence == 1)
+            e.first = pdu;
+
+        if(++e.received == e.total)
+        {
+            // the message is moved out and released before the handler runs,
+            // so the handler may add parts, which reuses slab_ and assembled_
+            auto message = std::move(assembled_);
+            message.clear();
+            for(const auto& [offset, size] : e.parts)
+                message.append(e.data, offset, size);
+            const auto first = std::move(e.first);
+            release(index);
+            handler_(first, message);
+            if(message.capacity() > assembled_.capacity())
+                assembled_ = std::move(message);
+            return true;
+        }
+
+        while(head_ != npos &&
+              (index_.size() > options_.max_messages ||
+               bytes_ > options_.max_bytes))
+            evict(head_);
+
+        return false;
+    }
+
+    /// Evict the messages that have timed out
+    void
+    expire(clock::time_point now = clock::now())
+    {
+        while(head_ != npos && now - slab_[head_].created >= options_.timeout)
+            evict(head_);
+    }
+
+    /// Return the number of incomplete messages
+    std::size_t
+    pending() const noexcept
+    {
+        return index_.size();
+    }
+
+    /// Return the number of octets held by the parts of incomplete messages
+    std::size_t
+    pending_bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+    /// Return the number of incomplete messages that have been evicted
+    std::size_t
+    evicted() const noexcept
+    {
+        return evicted_;
+    }
+
+private:
+    uint32_t
+    allocate(uint8_t total, clock::time_point now)
+    {
+        auto index = npos;
+        if(free_.empty())
+        {
+            index = static_cast<uint32_t>(slab_.size());
+            slab_.emplace_back();
+        }
+        else
+        {
+            index = free_.back();
+            free_.pop_back();
+        }
+
+        auto& e    = slab_[index];
+        e.key      = lookup_;
+        e.created  = now;
+        e.total    = total;
+        e.received = 0;
+        e.parts.assign(total, { 0, npos });
+
+        // new messages are the youngest
+        e.prev = tail_;
+        e.next = npos;
+        if(tail_ != npos)
+            slab_[tail_].next = index;
+        else
+            head_ = index;
+        tail_ = index;
+
+        return index;
+    }
+
+    void
+    release(uint32_t index)
+    {
+        auto& e = slab_[index];
+
+        if(e.prev != npos)
+            slab_[e.prev].next = e.next;
+        else
+            head_ = e.next;
+        if(e.next != npos)
+            slab_[e.next].prev = e.prev;
+        else
+            tail_ = e.prev;
+
+        index_.erase(e.key);
+        bytes_ -= e.data.size();
+        // the storage of the entry is kept for the next message
+        e.data.clear();
+        e.parts.clear();
+        free_.push_back(index);
+    }
+
+    void
+    evict(uint32_t index)
+    {
+        evicted_++;
+        release(index);
+    }
+};
+} // namespace smpp
@@ -0,0 +1,317 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace smpp
+{
+/// Releases scheduled messages and expires them at the end of their validity
+/**
+ * Each message has a release time, its schedule_delivery_time, and an expiry
+ * time, the end of its validity_period. The release handler is called when
+ * the release time is reached, and the expiry handler when the expiry time is
+ * reached, unless the message has been cancelled before, for example after it
+ * has been delivered. A message whose expiry time is not after its release
+ * time expires without being released, and a message without an expiry time
+ * is forgotten once it is released.
+ *
+ * Times are kept in a hierarchical timer wheel of one second ticks, four
+ * levels of 64 slots covering about 194 days, so scheduling and cancelling
+ * are constant time and advancing only visits the slots of elapsed ticks.
+ * Messages that are further away wait in the last level and are placed again
+ * as the wheel turns.
+ *
+ * Handlers may schedule and cancel messages. A message_scheduler is not
+ * thread-safe.
+ *
+ * @tparam T The type of messages
+ */
+template<typename T>
+class message_scheduler
+{
+public:
+    using clock   = std::chrono::system_clock;
+    using handle  = uint64_t;
+    using handler = std::function<void(T&)>;
+
+private:
+    static constexpr uint32_t npos      = static_cast<uint32_t>(-1);
+    static constexpr uint64_t never     = static_cast<uint64_t>(-1);
+    static constexpr int level_bits     = 6;
+    static constexpr int levels         = 4;
+    static constexpr uint64_t slot_mask = (1u << level_bits) - 1;
+    static constexpr uint64_t horizon   = uint64_t{ 1 }
+        << (level_bits * levels);
+
+    struct entry
+    {
+        std::optional<T> value;
+        uint64_t release{};
+        uint64_t expiry{};
+        uint32_t generation{};
+        uint32_t list{ npos };
+        uint32_t prev{ npos };
+        uint32_t next{ npos };
+        bool released{ false };
+    };
+
+    handler release_handler_;
+    handler expiry_handler_;
+    // a deque keeps the messages in place while handlers schedule new ones
+    std::deque<entry> slab_;
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, levels << level_bits> lists_;
+    uint64_t now_{};
+    std::size_t size_{};
+    uint32_t firing_{ npos };
+    bool firing_cancelled_{ false };
+
+public:
+    /// Construct a message_scheduler
+    /**
+     * @param release_handler The handler of messages that are released
+     * @param expiry_handler The handler of messages that expire
+     * @param now The current time
+     */
+    message_scheduler(
+        handler release_handler,
+        handler expiry_handler,
+        clock::time_point now = clock::now())
+        : release_handler_{ std::move(release_handler) }
+        , expiry_handler_{ std::move(expiry_handler) }
+        , now_{ to_tick(now, false) }
+    {
+        lists_.fill(npos);
+    }
+
+    /// Return the number of scheduled messages
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Schedule a message
+    /**
+     * Times that have already passed are reached by the next tick.
+     *
+     * @return A handle to cancel the message.
+     *
+     * @param value The message
+     * @param release The time to release the message
+     * @param expiry The time the message expires, clock::time_point::max() if
+     * it doesn't
+     */
+    handle
+    schedule(
+        T value,
+        clock::time_point release,
+        clock::time_point expiry = clock::time_point::max())
+    {
+        auto index = npos;
+        if(free_.empty())
+        {
+            index = static_cast<uint32_t>(slab_.size());
+            slab_.emplace_back();
+        }
+        else
+        {
+            index = free_.back();
+            free_.pop_back();
+        }
+
+        auto& e = slab_[index];
+        e.value.emplace(std::move(value));
+        e.release = std::max(to_tick(release, true), now_ + 1);
+        e.expiry  = expiry == clock::time_point::max()
+             ? never
+             : std::max(to_tick(expiry, true), now_ + 1);
+        e.released = false;
+        size_++;
+
+        link(index, next_event(e));
+        return static_cast<uint64_t>(e.generation) << 32 | index;
+    }
+
+    /// Cancel a message
+    /**
+     * @return A boolean indicating if the message was scheduled.
+     */
+    bool
+    cancel(handle h)
+    {
+        const auto index = static_cast<uint32_t>(h);
+        if(index >= slab_.size() || slab_[index].generation != (h >> 32) ||
+           !slab_[index].value)
+            return false;
+
+        if(index == firing_)
+        {
+            // the handler of the message is running
+            firing_cancelled_ = true;
+            return true;
+        }
+
+        unlink(index);
+        free_entry(index);
+        return true;
+    }
+
+    /// Release and expire the messages whose time has come
+    /**
+     * Should be called regularly, for example every second.
+     *
+     * @param now The current time
+     */
+    void
+    advance(clock::time_point now = clock::now())
+    {
+        const auto target = to_tick(now, false);
+        while(now_ < target)
+        {
+            if(size_ == 0)
+            {
+                now_ = target;
+                return;
+            }
+
+            now_++;
+            // higher levels are cascaded first, into the levels below them
+            for(auto level = levels - 1; level > 0; level--)
+            {
+                const auto shift = level * level_bits;
+                if((now_ & ((uint64_t{ 1 } << shift) - 1)) == 0)
+                    cascade(level, (now_ >> shift) & slot_mask);
+            }
+            fire(now_ & slot_mask);
+        }
+    }
+
+private:
+    static uint64_t
+    to_tick(clock::time_point time, bool round_up) noexcept
+    {
+        const auto since_epoch = time.time_since_epoch();
+        const auto seconds     = round_up
+                ? std::chrono::ceil<std::chrono::seconds>(since_epoch)
+                : std::chrono::floor<std::chrono::seconds>(since_epoch);
+        if(seconds.count() < 0)
+            return 0;
+        return static_cast<uint64_t>(seconds.count());
+    }
+
+    static uint64_t
+    next_event(const entry& e) noexcept
+    {
+        return !e.released && e.release < e.expiry ? e.release : e.expiry;
+    }
+
+    void
+    link(uint32_t index, uint64_t tick) noexcept
+    {
+        auto delta = tick - now_;
+        if(delta >= horizon)
+        {
+            // placed again when the last level turns
+            delta = horizon - 1;
+            tick  = now_ + delta;
+        }
+
+        auto level = 0;
+        while(level < levels - 1 &&
+              delta >= uint64_t{ 1 } << ((level + 1) * level_bits))
+            level++;
+
+        const auto list = static_cast<uint32_t>(
+            level << level_bits |
+            ((tick >> (level * level_bits)) & slot_mask));
+
+        auto& e = slab_[index];
+        e.list  = list;
+        e.prev  = npos;
+        e.next  = lists_[list];
+        if(e.next != npos)
+            slab_[e.next].prev = index;
+        lists_[list] = index;
+    }
+
+    void
+    unlink(uint32_t index) noexcept
+    {
+        auto& e = slab_[index];
+        if(e.prev != npos)
+            slab_[e.prev].next = e.next;
+        else
+            lists_[e.list] = e.next;
+        if(e.next != npos)
+            slab_[e.next].prev = e.prev;
+        e.list = npos;
+    }
+
+    void
+    free_entry(uint32_t index)
+    {
+        auto& e = slab_[index];
+        e.value.reset();
+        e.generation++;
+        free_.push_back(index);
+        size_--;
+    }
+
+    void
+    cascade(int level, uint64_t slot) noexcept
+    {
+        const auto list = static_cast<uint32_t>(level << level_bits | slot);
+        while(lists_[list] != npos)
+        {
+            const auto index = lists_[list];
+            unlink(index);
+            link(index, next_event(slab_[index]));
+        }
+    }
+
+    void
+    fire(uint64_t slot)
+    {
+        // handlers can't add to this slot, new times are at least a tick away
+        while(lists_[slot] != npos)
+        {
+            const auto index = lists_[slot];
+            auto& e          = slab_[index];
+            unlink(index);
+
+            firing_           = index;
+            firing_cancelled_ = false;
+
+            if(!e.released && e.release < e.expiry)
+            {
+                e.released = true;
+                release_handler_(*e.value);
+                firing_ = npos;
+
+                if(!firing_cancelled_ && e.expiry != never)
+                    link(index, e.expiry);
+                else
+                    free_entry(index);
+            }
+            else
+            {
+                expiry_handler_(*e.value);
+                firing_ = npos;
+                free_entry(index);
+            }
+        }
+    }
+};
+} // namespace smpp
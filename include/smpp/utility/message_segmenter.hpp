@@ -0,0 +1,367 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <smpp/pdu/data_sm.hpp>
+#include <smpp/pdu/submit_sm.hpp>
+#include <smpp/utility/encoding_planner.hpp>
+#include <smpp/utility/unicode_converter.hpp>
+
+#include <array>
+#include <cinttypes>
+#include <concepts>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smpp
+{
+enum class concatenation : uint8_t
+{
+    udh_8bit,       // concatenated short messages IE with 8-bit reference
+    udh_16bit,      // concatenated short messages IE with 16-bit reference
+    sar,            // sar_msg_ref_num, sar_total_segments, sar_segment_seqnum
+    message_payload // a single PDU with the whole text in message_payload
+};
+
+struct segmentation_options
+{
+    // The way that the segments are linked together
+    smpp::concatenation concatenation{ concatenation::udh_8bit };
+
+    // The options of choosing the data_coding
+    encoding_options encoding{};
+};
+
+/// Allocates concatenation reference numbers per destination
+/**
+ * Each destination hashes to one of a fixed set of counters, so allocation
+ * never allocates memory. Consecutive messages to the same destination get
+ * consecutive reference numbers, destinations that share a counter only make
+ * the numbers wrap sooner.
+ */
+class reference_allocator
+{
+    std::array<uint16_t, 4096> counters_{};
+
+public:
+    /// Return the next reference number of a destination
+    uint16_t
+    next(std::string_view dest_addr) noexcept
+    {
+        const auto hash = std::hash<std::string_view>{}(dest_addr);
+        return ++counters_[hash % counters_.size()];
+    }
+};
+
+namespace detail
+{
+// Returns the end of the segment that starts at pos, without splitting an
+// escaped GSM character or a UTF-16 surrogate pair
+inline std::size_t
+segment_end(
+    std::string_view encoded,
+    std::size_t pos,
+    std::size_t capacity,
+    data_coding data_coding) noexcept
+{
+    if(pos + capacity >= encoded.size())
+        return encoded.size();
+
+    if(data_coding == data_coding::iso8859_1)
+        return pos + capacity;
+
+    const auto limit = pos + capacity;
+    while(pos < limit)
+    {
+        auto step = std::size_t{ 1 };
+        if(data_coding == data_coding::defaults)
+        {
+            step = encoded[pos] == gsm_escape ? 2 : 1;
+        }
+        else
+        {
+            const auto high = static_cast<uint8_t>(encoded[pos]);
+            step            = high >= 0xD8 && high <= 0xDB ? 4 : 2;
+        }
+
+        if(pos + step > limit)
+            break;
+
+        pos += step;
+    }
+    return pos;
+}
+} // namespace detail
+
+/// Splits long messages into ready to send submit_sm or data_sm PDUs
+/**
+ * The data_coding is chosen by plan_encoding. GSM 03.38 texts are written as
+ * unpacked septets, one septet per octet, and their segment sizes are those of
+ * the packed septets that the SMSC would send. Segments never split an
+ * escaped GSM character or a UTF-16 surrogate pair.
+ *
+ * A message_segmenter keeps its encoding buffer between messages, and the
+ * PDUs of the parts vector are assigned in place, so segmenting into the same
+ * vector again reuses their storage.
+ */
+class message_segmenter
+{
+    segmentation_options options_;
+    reference_allocator references_;
+    std::string encoded_;
+    std::string payload_;
+
+public:
+    /// Construct a message_segmenter
+    /**
+     * @param options The segmentation options
+     */
+    explicit message_segmenter(segmentation_options options = {})
+        : options_{ options }
+    {
+    }
+
+    /// Return the reference allocator
+    reference_allocator&
+    references() noexcept
+    {
+        return references_;
+    }
+
+    /// Split a message
+    /**
+     * Each part is a copy of the prototype with its data_coding, esm_class
+     * and message set. The message of submit_sm goes in short_message, unless
+     * concatenation is message_payload, and the message of data_sm always goes
+     * in the message_payload optional parameter.
+     *
+     * Throws std::invalid_argument on invalid UTF-8 and std::length_error if
+     * the message needs more than 255 parts.
+     *
+     * @return The number of parts.
+     *
+     * @param prototype The PDU that parts would be copied from, with the
+     * addresses and the other fields set
+     * @param utf8 The UTF-8 text
+     * @param parts The vector that is resized to the number of parts
+     */
+    template<typename Pdu>
+        requires std::same_as<Pdu, submit_sm> || std::same_as<Pdu, data_sm>
+    std::size_t
+    segment(
+        const Pdu& prototype,
+        std::string_view utf8,
+        std::vector<Pdu>& parts)
+    {
+        const auto plan     = plan_encoding(utf8, options_.encoding);
+        const auto alphabet = plan.alphabet;
+        const auto is_gsm   = plan.data_coding == data_coding::defaults;
+        encode(utf8, plan);
+
+        // national language IEs
+        auto language_ies = std::array<char, 6>{};
+        auto language_len = std::size_t{};
+        if(alphabet.single_shift != gsm_national_language::none)
+        {
+            language_ies[language_len++] = 0x24;
+            language_ies[language_len++] = 0x01;
+            language_ies[language_len++] =
+                static_cast<char>(alphabet.single_shift);
+        }
+        if(alphabet.locking_shift != gsm_national_language::none)
+        {
+            language_ies[language_len++] = 0x25;
+            language_ies[language_len++] = 0x01;
+            language_ies[language_len++] =
+                static_cast<char>(alphabet.locking_shift);
+        }
+        const auto language = std::string_view{ language_ies.data(),
+                                                language_len };
+
+        auto capacity = [&](std::size_t ie_octets) -> std::size_t
+        {
+            if(is_gsm)
+                return detail::gsm_segment_capacity(ie_octets);
+            return ie_octets == 0 ? 140 : 140 - 1 - ie_octets;
+        };
+
+        const auto method  = options_.concatenation;
+        const auto encoded = std::string_view{ encoded_ };
+
+        if(method == concatenation::message_payload ||
+           encoded.size() <= capacity(language.size()))
+        {
+            parts.resize(1);
+            assign(parts[0], prototype, plan, !language.empty());
+            set_message(parts[0], language, {}, encoded);
+            return 1;
+        }
+
+        const auto concat_octets = method == concatenation::udh_8bit
+            ? std::size_t{ 5 }
+            : method == concatenation::udh_16bit ? std::size_t{ 6 }
+                                                 : std::size_t{ 0 };
+        const auto segment_capacity =
+            capacity(concat_octets + language.size());
+
+        auto total = std::size_t{};
+        for(auto pos = std::size_t{}; pos != encoded.size(); total++)
+            pos = detail::segment_end(
+                encoded, pos, segment_capacity, plan.data_coding);
+
+        if(total > 255)
+            throw std::length_error{ "message needs more than 255 parts" };
+
+        const auto reference = references_.next(prototype.dest_addr);
+
+        parts.resize(total);
+        auto pos = std::size_t{};
+        for(auto i = std::size_t{}; i < total; i++)
+        {
+            const auto end = detail::segment_end(
+                encoded, pos, segment_capacity, plan.data_coding);
+            const auto body = encoded.substr(pos, end - pos);
+            pos             = end;
+
+            const auto seq = static_cast<char>(i + 1);
+            const auto tot = static_cast<char>(total);
+
+            auto concat_ies = std::array<char, 6>{};
+            auto concat     = std::string_view{};
+            if(method == concatenation::udh_8bit)
+            {
+                concat_ies = { 0x00, 0x03, static_cast<char>(reference & 0xFF),
+                               tot,  seq };
+                concat     = { concat_ies.data(), 5 };
+            }
+            else if(method == concatenation::udh_16bit)
+            {
+                concat_ies = { 0x08,
+                               0x04,
+                               static_cast<char>(reference >> 8),
+                               static_cast<char>(reference & 0xFF),
+                               tot,
+                               seq };
+                concat     = { concat_ies.data(), 6 };
+            }
+
+            // the first part is built from the prototype and the others are
+            // copied from it, only their message and sequence number change
+            auto& part = parts[i];
+            if(i == 0)
+            {
+                const auto udhi =
+                    method != concatenation::sar || !language.empty();
+                assign(part, prototype, plan, udhi);
+                if(method == concatenation::sar)
+                {
+                    part.oparam.set_as_string(
+                        oparam_tag::sar_msg_ref_num,
+                        { static_cast<char>(reference >> 8),
+                          static_cast<char>(reference & 0xFF) });
+                    part.oparam.set_as_string(
+                        oparam_tag::sar_total_segments, { tot });
+                }
+            }
+            else
+            {
+                part = parts[0];
+            }
+
+            if(method == concatenation::sar)
+                part.oparam.set_as_string(
+                    oparam_tag::sar_segment_seqnum, { seq });
+
+            set_message(part, language, concat, body);
+        }
+
+        return total;
+    }
+
+private:
+    void
+    encode(std::string_view utf8, const encoding_plan& plan)
+    {
+        switch(plan.data_coding)
+        {
+        case data_coding::defaults:
+            encoded_.resize(max_gsm_size(utf8.size()));
+            encoded_.resize(convert_utf8_to_gsm(
+                utf8,
+                encoded_.data(),
+                options_.encoding.transliterate,
+                plan.alphabet));
+            break;
+        case data_coding::iso8859_1:
+            encoded_ = convert_utf8_to_latin1(utf8);
+            break;
+        default:
+            encoded_.resize(max_ucs2_size(utf8.size()));
+            encoded_.resize(convert_utf8_to_ucs2(utf8, encoded_.data()));
+            break;
+        }
+    }
+
+    template<typename Pdu>
+    void
+    assign(
+        Pdu& part,
+        const Pdu& prototype,
+        const encoding_plan& plan,
+        bool udhi)
+    {
+        part             = prototype;
+        part.data_coding = plan.data_coding;
+
+        if(udhi)
+        {
+            auto& features = part.esm_class.gsm_network_features;
+            features       = features == gsm_network_features::reply_path ||
+                    features == gsm_network_features::both
+                      ? gsm_network_features::both
+                      : gsm_network_features::uhdi;
+        }
+    }
+
+    template<typename Pdu>
+    void
+    set_message(
+        Pdu& part,
+        std::string_view language,
+        std::string_view concat,
+        std::string_view body)
+    {
+        const auto udh_length = concat.size() + language.size();
+
+        auto& out = payload_;
+        out.clear();
+        if(udh_length != 0)
+        {
+            out.push_back(static_cast<char>(udh_length));
+            out.append(concat);
+            out.append(language);
+        }
+        out.append(body);
+
+        const auto in_payload = std::same_as<Pdu, data_sm> ||
+            options_.concatenation == concatenation::message_payload;
+
+        if constexpr(std::same_as<Pdu, submit_sm>)
+        {
+            if(!in_payload)
+            {
+                part.short_message.assign(out);
+                return;
+            }
+            part.short_message.clear();
+        }
+
+        part.oparam.set_as_string(oparam_tag::message_payload, out);
+    }
+};
+} // namespace smpp
@@ -6,17 +6,26 @@
 
 #include <smpp/param/esm_class.hpp>
 #include <smpp/utility/data_coding_unicode.hpp>
+#include <smpp/utility/gsm_national_language.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
+#include <cstring>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <utility>
-#include <vector>
 
 namespace smpp
 {
+/// A user data header with inline storage
+/**
+ * The information elements are kept serialized in an inline buffer, with a
+ * table of their offsets, so constructing, parsing and serializing a
+ * user_data_header never allocates memory.
+ */
 class user_data_header
 {
 public:
@@ -32,18 +41,31 @@ public:
         uint8_t sequence_number_{};
     };
 
+    // The UDH and its length octet fit in the 140 octets of a short message
+    static constexpr std::size_t max_size{ 139 };
+
 private:
     static constexpr uint8_t concatenated_sm_8bit_ref{ 0x00 };
     static constexpr uint8_t concatenated_sm_16bit_ref{ 0x08 };
+    static constexpr uint8_t national_language_single_shift{ 0x24 };
+    static constexpr uint8_t national_language_locking_shift{ 0x25 };
+    static constexpr std::size_t header_length{ 2 };
 
-    std::vector<std::pair<uint8_t, std::string>> headers_;
+    std::array<char, max_size> buf_{};
+    std::array<uint8_t, max_size / header_length> offsets_{};
+    uint8_t size_{};
+    uint8_t count_{};
 
 public:
     user_data_header() = default;
 
     explicit user_data_header(std::string_view buf)
     {
-        const auto constexpr header_length = 2;
+        if(buf.size() > max_size)
+            throw std::length_error{
+                "user_data_header length is larger than 139"
+            };
+
         while(buf.size() >= header_length)
         {
             const auto tag        = static_cast<uint8_t>(buf[0]);
@@ -62,7 +84,14 @@ public:
                     "user_data_header multi_part_data length is invalid"
                 };
 
-            headers_.emplace_back(tag, val_buf);
+            if((tag == national_language_single_shift ||
+                tag == national_language_locking_shift) &&
+               val_buf.size() != 1)
+                throw std::length_error{
+                    "user_data_header national language length is invalid"
+                };
+
+            add(tag, val_buf);
 
             buf = buf.substr(val_length + header_length);
         }
@@ -73,137 +102,288 @@ public:
         set_multi_part_data(mpd);
     }
 
+    bool
+    operator==(const user_data_header& other) const noexcept
+    {
+        return view() == other.view();
+    }
+
     std::string
     serialize() const
     {
-        std::string buf;
-        for(const auto& [tag, val] : headers_)
+        return std::string{ view() };
+    }
+
+    /// Return the serialized information elements
+    std::string_view
+    view() const noexcept
+    {
+        return { buf_.data(), size_ };
+    }
+
+    /// Return the number of information elements
+    std::size_t
+    count() const noexcept
+    {
+        return count_;
+    }
+
+    /// Return the value of the first information element with a tag
+    std::optional<std::string_view>
+    find(uint8_t tag) const noexcept
+    {
+        for(auto i = std::size_t{}; i < count_; i++)
         {
-            buf.append(
-                { static_cast<char>(tag), static_cast<char>(val.size()) });
-            buf.insert(buf.end(), val.begin(), val.end());
+            const auto offset = offsets_[i];
+            if(static_cast<uint8_t>(buf_[offset]) == tag)
+                return std::string_view{
+                    buf_.data() + offset + header_length,
+                    static_cast<uint8_t>(buf_[offset + 1])
+                };
         }
-        return buf;
+        return std::nullopt;
+    }
+
+    /// Add an information element
+    /**
+     * @throw std::length_error if the header would be larger than max_size.
+     *
+     * @param tag The information element identifier
+     * @param val The information element data
+     */
+    void
+    add(uint8_t tag, std::string_view val)
+    {
+        if(size_ + header_length + val.size() > max_size)
+            throw std::length_error{
+                "user_data_header length is larger than 139"
+            };
+
+        offsets_[count_++] = size_;
+        buf_[size_++]      = static_cast<char>(tag);
+        buf_[size_++]      = static_cast<char>(val.size());
+        std::copy(val.begin(), val.end(), buf_.begin() + size_);
+        size_ += static_cast<uint8_t>(val.size());
+    }
+
+    /// Erase the information elements with a tag
+    /**
+     * @return A boolean indicating if there was an information element with
+     * this tag.
+     */
+    bool
+    erase(uint8_t tag) noexcept
+    {
+        auto size  = uint8_t{};
+        auto count = uint8_t{};
+        for(auto i = std::size_t{}; i < count_; i++)
+        {
+            const auto offset = offsets_[i];
+            const auto length = static_cast<uint8_t>(
+                header_length + static_cast<uint8_t>(buf_[offset + 1]));
+
+            if(static_cast<uint8_t>(buf_[offset]) == tag)
+                continue;
+
+            std::memmove(buf_.data() + size, buf_.data() + offset, length);
+            offsets_[count++] = size;
+            size += length;
+        }
+
+        const auto erased = count != count_;
+        size_             = size;
+        count_            = count;
+        return erased;
     }
 
     void
     set_multi_part_data(const multi_part_data& mpd)
     {
+        erase(concatenated_sm_8bit_ref);
+        erase(concatenated_sm_16bit_ref);
+
         if(mpd.concat_sm_ref_num_ > 0xFF)
         {
-            headers_.emplace_back(
-                concatenated_sm_16bit_ref,
-                std::string{
-                    { static_cast<char>((mpd.concat_sm_ref_num_ >> 8) & 0xFF),
-                      static_cast<char>((mpd.concat_sm_ref_num_ >> 0) & 0xFF),
-                      static_cast<char>(mpd.number_of_parts_),
-                      static_cast<char>(mpd.sequence_number_) } });
+            const char val[] = {
+                static_cast<char>((mpd.concat_sm_ref_num_ >> 8) & 0xFF),
+                static_cast<char>((mpd.concat_sm_ref_num_ >> 0) & 0xFF),
+                static_cast<char>(mpd.number_of_parts_),
+                static_cast<char>(mpd.sequence_number_)
+            };
+            add(concatenated_sm_16bit_ref, { val, sizeof(val) });
         }
         else
         {
-            headers_.emplace_back(
-                concatenated_sm_8bit_ref,
-                std::string{ { static_cast<char>(mpd.concat_sm_ref_num_),
-                               static_cast<char>(mpd.number_of_parts_),
-                               static_cast<char>(mpd.sequence_number_) } });
+            const char val[] = { static_cast<char>(mpd.concat_sm_ref_num_),
+                                 static_cast<char>(mpd.number_of_parts_),
+                                 static_cast<char>(mpd.sequence_number_) };
+            add(concatenated_sm_8bit_ref, { val, sizeof(val) });
         }
     }
 
     multi_part_data
     get_multi_part_data() const
     {
+        auto octet = [](std::string_view val, std::size_t i)
+        { return static_cast<uint8_t>(val[i]); };
+
+        if(const auto val = find(concatenated_sm_8bit_ref))
+            return { octet(*val, 0), octet(*val, 1), octet(*val, 2) };
+
+        if(const auto val = find(concatenated_sm_16bit_ref))
+            return { static_cast<uint16_t>(
+                         octet(*val, 0) << 8 | octet(*val, 1)),
+                     octet(*val, 2),
+                     octet(*val, 3) };
+
+        return { .concat_sm_ref_num_ = 0,
+                 .number_of_parts_   = 1,
+                 .sequence_number_   = 1 };
+    }
+
+    void
+    set_gsm_alphabet(const gsm_alphabet& alphabet)
+    {
+        erase(national_language_single_shift);
+        erase(national_language_locking_shift);
+
+        if(alphabet.single_shift != gsm_national_language::none)
         {
-            const auto it = std::find_if(
-                headers_.begin(),
-                headers_.end(),
-                [](const auto& h)
-                { return h.first == concatenated_sm_8bit_ref; });
-            if(it != headers_.end())
-                return { static_cast<uint16_t>(it->second[0]),
-                         static_cast<uint8_t>(it->second[1]),
-                         static_cast<uint8_t>(it->second[2]) };
+            const auto val = static_cast<char>(alphabet.single_shift);
+            add(national_language_single_shift, { &val, 1 });
         }
 
+        if(alphabet.locking_shift != gsm_national_language::none)
         {
-            const auto it = std::find_if(
-                headers_.begin(),
-                headers_.end(),
-                [](const auto& h)
-                { return h.first == concatenated_sm_16bit_ref; });
-            if(it != headers_.end())
-                return { static_cast<uint16_t>(
-                             static_cast<uint16_t>(it->second[0]) << 8 |
-                             static_cast<uint16_t>(it->second[1])),
-                         static_cast<uint8_t>(it->second[2]),
-                         static_cast<uint8_t>(it->second[3]) };
+            const auto val = static_cast<char>(alphabet.locking_shift);
+            add(national_language_locking_shift, { &val, 1 });
         }
+    }
 
-        return { .concat_sm_ref_num_ = 0,
-                 .number_of_parts_   = 1,
-                 .sequence_number_   = 1 };
+    gsm_alphabet
+    get_gsm_alphabet() const
+    {
+        auto alphabet = gsm_alphabet{};
+        if(const auto val = find(national_language_single_shift))
+            alphabet.single_shift =
+                static_cast<gsm_national_language>((*val)[0]);
+        if(const auto val = find(national_language_locking_shift))
+            alphabet.locking_shift =
+                static_cast<gsm_national_language>((*val)[0]);
+        return alphabet;
     }
 };
 
-inline std::pair<user_data_header, std::string>
-unpack_short_message(
-    esm_class esm_class,
-    data_coding data_coding,
-    const std::string& short_message)
+namespace detail
+{
+inline void
+check_short_message_size(data_coding data_coding, std::size_t size)
 {
     if(extract_unicode(data_coding) == data_coding_unicode::ascii_8_bit)
     {
-        if(short_message.length() > 160)
+        if(size > 160)
             throw std::length_error("short_message length is larger than 160");
     }
     else
     {
-        if(short_message.length() > 140)
+        if(size > 140)
             throw std::length_error("short_message length is larger than 140");
     }
+}
+} // namespace detail
+
+/// Unpack a short message into its user data header and its body
+/**
+ * @throw std::length_error if the short message or its UDH is too long.
+ *
+ * @return The body, a view into short_message.
+ *
+ * @param esm_class The esm_class of the PDU, that indicates a UDH
+ * @param data_coding The data_coding of the PDU
+ * @param short_message The short message
+ * @param user_data_header The user_data_header that is parsed into
+ */
+inline std::string_view
+unpack_short_message(
+    esm_class esm_class,
+    data_coding data_coding,
+    std::string_view short_message,
+    user_data_header& user_data_header)
+{
+    detail::check_short_message_size(data_coding, short_message.size());
 
     if(esm_class.gsm_network_features == gsm_network_features::uhdi ||
        esm_class.gsm_network_features == gsm_network_features::both)
     {
-        const auto udh_length = static_cast<uint8_t>(short_message[0]);
+        const auto udh_length = short_message.empty()
+            ? std::size_t{}
+            : static_cast<uint8_t>(short_message[0]);
 
         if(udh_length >= short_message.length())
             throw std::length_error("UDH lenght is larger than short_message");
 
-        return { user_data_header{ short_message.substr(1, udh_length) },
-                 short_message.substr(1 + udh_length) };
+        user_data_header = smpp::user_data_header{ short_message.substr(
+            1, udh_length) };
+        return short_message.substr(1 + udh_length);
     }
 
-    return { user_data_header{}, short_message };
+    user_data_header = {};
+    return short_message;
 }
 
-inline std::string
+/// Pack a user data header and a body into a short message
+/**
+ * @throw std::length_error if the short message would be too long.
+ *
+ * @return The number of octets written.
+ *
+ * @param user_data_header The user_data_header
+ * @param body The body
+ * @param data_coding The data_coding of the PDU
+ * @param out The output buffer, it should have room for 160 octets
+ */
+inline std::size_t
 pack_short_message(
     const user_data_header& user_data_header,
     std::string_view body,
-    data_coding data_coding)
+    data_coding data_coding,
+    char* out)
 {
-    std::string short_message;
+    const auto udh  = user_data_header.view();
+    const auto size = (udh.empty() ? 0 : 1 + udh.size()) + body.size();
+    detail::check_short_message_size(data_coding, size);
 
-    const auto serialized_udh = user_data_header.serialize();
-    if(serialized_udh.length() != 0)
+    if(!udh.empty())
     {
-        short_message.push_back(static_cast<char>(serialized_udh.length()));
-        short_message.append(serialized_udh);
+        *out++ = static_cast<char>(udh.size());
+        out    = std::copy(udh.begin(), udh.end(), out);
     }
+    std::copy(body.begin(), body.end(), out);
 
-    short_message.append(body);
+    return size;
+}
 
-    if(extract_unicode(data_coding) == data_coding_unicode::ascii_8_bit)
-    {
-        if(short_message.length() > 160)
-            throw std::length_error("short_message length is larger than 160");
-    }
-    else
-    {
-        if(short_message.length() > 140)
-            throw std::length_error("short_message length is larger than 140");
-    }
+inline std::pair<user_data_header, std::string>
+unpack_short_message(
+    esm_class esm_class,
+    data_coding data_coding,
+    const std::string& short_message)
+{
+    auto user_data_header = smpp::user_data_header{};
+    const auto body       = unpack_short_message(
+        esm_class, data_coding, short_message, user_data_header);
+    return { user_data_header, std::string{ body } };
+}
 
+inline std::string
+pack_short_message(
+    const user_data_header& user_data_header,
+    std::string_view body,
+    data_coding data_coding)
+{
+    auto short_message = std::string(160, '\0');
+    short_message.resize(pack_short_message(
+        user_data_header, body, data_coding, short_message.data()));
     return short_message;
 }
 } // namespace smpp
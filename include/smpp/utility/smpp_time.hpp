@@ -0,0 +1,175 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace smpp
+{
+// The length of an SMPP time without its NULL terminator
+inline constexpr std::size_t smpp_time_size{ 16 };
+
+using smpp_time_point = std::chrono::sys_time<std::chrono::milliseconds>;
+
+namespace detail
+{
+inline constexpr char*
+format_smpp_time_fields(const int (&fields)[6], char* out) noexcept
+{
+    for(auto field : fields)
+    {
+        *out++ = static_cast<char>('0' + field / 10);
+        *out++ = static_cast<char>('0' + field % 10);
+    }
+    return out;
+}
+} // namespace detail
+
+/// Parse an SMPP time
+/**
+ * Parses the YYMMDDhhmmsstnnp format of schedule_delivery_time,
+ * validity_period and final_date. An absolute time is converted to UTC using
+ * its quarter-hour offset, and years are taken as 20YY. A relative time,
+ * where p is 'R', is added to now; adding its years and months is clamped to
+ * the last day of the month, like 31 January plus one month.
+ *
+ * The digits are validated all at once and the function is usable in
+ * constant expressions.
+ *
+ * @return The time in UTC, or std::nullopt if the time is empty or malformed.
+ *
+ * @param time The time
+ * @param now The reference of relative times
+ */
+inline constexpr std::optional<smpp_time_point>
+parse_smpp_time(
+    std::string_view time,
+    smpp_time_point now = std::chrono::floor<std::chrono::milliseconds>(
+        std::chrono::system_clock::now())) noexcept
+{
+    using namespace std::chrono;
+
+    if(time.size() != smpp_time_size)
+        return std::nullopt;
+
+    int digits[15] = {};
+    auto invalid   = false;
+    for(auto i = 0; i < 15; i++)
+    {
+        digits[i] = time[i] - '0';
+        invalid |= static_cast<unsigned>(digits[i]) > 9;
+    }
+
+    auto field = [&](int i) { return digits[i * 2] * 10 + digits[i * 2 + 1]; };
+
+    const auto p = time[15];
+    if(p == 'R')
+    {
+        if(invalid)
+            return std::nullopt;
+
+        const auto today = floor<days>(now);
+        auto ymd = year_month_day{ today } + years{ field(0) } +
+            months{ field(1) };
+        if(!ymd.ok())
+            ymd = year_month_day{ ymd.year() / ymd.month() / last };
+
+        return sys_days{ ymd } + (now - today) + days{ field(2) } +
+            hours{ field(3) } + minutes{ field(4) } + seconds{ field(5) };
+    }
+
+    const auto ymd     = year{ 2000 + field(0) } / field(1) / field(2);
+    const auto quarter = digits[13] * 10 + digits[14];
+    invalid |= (p != '+') & (p != '-');
+    invalid |= (field(3) > 23) | (field(4) > 59) | (field(5) > 59);
+    invalid |= quarter > 48;
+    if(invalid || !ymd.ok())
+        return std::nullopt;
+
+    const auto local = sys_days{ ymd } + hours{ field(3) } +
+        minutes{ field(4) } + seconds{ field(5) } +
+        milliseconds{ digits[12] * 100 };
+    const auto offset = minutes{ quarter * 15 };
+
+    // '+' means the local time is ahead of UTC
+    return p == '+' ? local - offset : local + offset;
+}
+
+/// Format an absolute SMPP time
+/**
+ * The time is formatted in UTC, with an offset of 00+, as YYMMDDhhmmsst00+.
+ * Years outside 2000 to 2099 wrap around.
+ *
+ * @return The end of the written characters, smpp_time_size after out.
+ *
+ * @param time The time
+ * @param out The output buffer
+ */
+inline constexpr char*
+format_smpp_time(smpp_time_point time, char* out) noexcept
+{
+    using namespace std::chrono;
+
+    const auto today = floor<days>(time);
+    const auto ymd   = year_month_day{ today };
+    const auto hms   = hh_mm_ss{ time - today };
+
+    const int fields[6] = { static_cast<int>(ymd.year()) % 100,
+                            static_cast<int>(unsigned{ ymd.month() }),
+                            static_cast<int>(unsigned{ ymd.day() }),
+                            static_cast<int>(hms.hours().count()),
+                            static_cast<int>(hms.minutes().count()),
+                            static_cast<int>(hms.seconds().count()) };
+
+    out    = detail::format_smpp_time_fields(fields, out);
+    *out++ = static_cast<char>('0' + hms.subseconds().count() / 100);
+    *out++ = '0';
+    *out++ = '0';
+    *out++ = '+';
+    return out;
+}
+
+/// Format a relative SMPP time
+/**
+ * The duration is formatted as 0000DDhhmmss000R, in days, hours, minutes and
+ * seconds, so it doesn't depend on the length of months.
+ *
+ * @throw std::out_of_range if the duration is negative or 100 days or more.
+ *
+ * @return The end of the written characters, smpp_time_size after out.
+ *
+ * @param duration The duration
+ * @param out The output buffer
+ */
+inline constexpr char*
+format_smpp_relative_time(std::chrono::seconds duration, char* out)
+{
+    using namespace std::chrono;
+
+    if(duration < seconds{} || duration >= days{ 100 })
+        throw std::out_of_range{ "relative SMPP time is out of range" };
+
+    const auto whole = floor<days>(duration);
+    const auto hms   = hh_mm_ss{ duration - whole };
+
+    const int fields[6] = { 0,
+                            0,
+                            static_cast<int>(whole.count()),
+                            static_cast<int>(hms.hours().count()),
+                            static_cast<int>(hms.minutes().count()),
+                            static_cast<int>(hms.seconds().count()) };
+
+    out    = detail::format_smpp_time_fields(fields, out);
+    *out++ = '0';
+    *out++ = '0';
+    *out++ = '0';
+    *out++ = 'R';
+    return out;
+}
+} // namespace smpp
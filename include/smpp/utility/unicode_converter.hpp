@@ -4,93 +4,39 @@
 
 #pragma once
 
+#include <smpp/utility/detail/gsm_03_38.hpp>
+#include <smpp/utility/detail/transliteration.hpp>
+
 #include <array>
 #include <cinttypes>
+#include <cstddef>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 namespace smpp
 {
+/// Convert unpacked GSM 03.38 septets to big-endian UCS-2
+/**
+ * Septets that are not defined in the tables are converted to space.
+ *
+ * @param body The unpacked septets
+ * @param alphabet The national language tables of the message, see
+ * user_data_header::get_gsm_alphabet
+ */
 inline std::string
-convert_gsm_to_ucs2(std::string_view body)
+convert_gsm_to_ucs2(std::string_view body, gsm_alphabet alphabet = {})
 {
-    struct word
-    {
-        uint8_t h{};
-        uint8_t l{};
-    };
-
-    static constexpr std::array<word, 128> gsm_03_38_to_ucs2 = {
-        { { 0x00, 0x40 }, { 0x00, 0xA3 }, { 0x00, 0x24 }, { 0x00, 0xA5 },
-          { 0x00, 0xE8 }, { 0x00, 0xE9 }, { 0x00, 0xF9 }, { 0x00, 0xEC },
-          { 0x00, 0xF2 }, { 0x00, 0xE7 }, { 0x00, 0x0A }, { 0x00, 0xD8 },
-          { 0x00, 0xF8 }, { 0x00, 0x0D }, { 0x00, 0xC5 }, { 0x00, 0xE5 },
-          { 0x03, 0x94 }, { 0x00, 0x5F }, { 0x03, 0xA6 }, { 0x03, 0x93 },
-          { 0x03, 0x9B }, { 0x03, 0xA9 }, { 0x03, 0xA0 }, { 0x03, 0xA8 },
-          { 0x03, 0xA3 }, { 0x03, 0x98 }, { 0x03, 0x9E }, { 0x00, 0xA0 },
-          { 0x00, 0xC6 }, { 0x00, 0xE6 }, { 0x00, 0xDF }, { 0x00, 0xC9 },
-          { 0x00, 0x20 }, { 0x00, 0x21 }, { 0x00, 0x22 }, { 0x00, 0x23 },
-          { 0x00, 0xA4 }, { 0x00, 0x25 }, { 0x00, 0x26 }, { 0x00, 0x27 },
-          { 0x00, 0x28 }, { 0x00, 0x29 }, { 0x00, 0x2A }, { 0x00, 0x2B },
-          { 0x00, 0x2C }, { 0x00, 0x2D }, { 0x00, 0x2E }, { 0x00, 0x2F },
-          { 0x00, 0x30 }, { 0x00, 0x31 }, { 0x00, 0x32 }, { 0x00, 0x33 },
-          { 0x00, 0x34 }, { 0x00, 0x35 }, { 0x00, 0x36 }, { 0x00, 0x37 },
-          { 0x00, 0x38 }, { 0x00, 0x39 }, { 0x00, 0x3A }, { 0x00, 0x3B },
-          { 0x00, 0x3C }, { 0x00, 0x3D }, { 0x00, 0x3E }, { 0x00, 0x3F },
-          { 0x00, 0xA1 }, { 0x00, 0x41 }, { 0x00, 0x42 }, { 0x00, 0x43 },
-          { 0x00, 0x44 }, { 0x00, 0x45 }, { 0x00, 0x46 }, { 0x00, 0x47 },
-          { 0x00, 0x48 }, { 0x00, 0x49 }, { 0x00, 0x4A }, { 0x00, 0x4B },
-          { 0x00, 0x4C }, { 0x00, 0x4D }, { 0x00, 0x4E }, { 0x00, 0x4F },
-          { 0x00, 0x50 }, { 0x00, 0x51 }, { 0x00, 0x52 }, { 0x00, 0x53 },
-          { 0x00, 0x54 }, { 0x00, 0x55 }, { 0x00, 0x56 }, { 0x00, 0x57 },
-          { 0x00, 0x58 }, { 0x00, 0x59 }, { 0x00, 0x5A }, { 0x00, 0xC4 },
-          { 0x00, 0xD6 }, { 0x00, 0xD1 }, { 0x00, 0xDC }, { 0x00, 0xA7 },
-          { 0x00, 0xBF }, { 0x00, 0x61 }, { 0x00, 0x62 }, { 0x00, 0x63 },
-          { 0x00, 0x64 }, { 0x00, 0x65 }, { 0x00, 0x66 }, { 0x00, 0x67 },
-          { 0x00, 0x68 }, { 0x00, 0x69 }, { 0x00, 0x6A }, { 0x00, 0x6B },
-          { 0x00, 0x6C }, { 0x00, 0x6D }, { 0x00, 0x6E }, { 0x00, 0x6F },
-          { 0x00, 0x70 }, { 0x00, 0x71 }, { 0x00, 0x72 }, { 0x00, 0x73 },
-          { 0x00, 0x74 }, { 0x00, 0x75 }, { 0x00, 0x76 }, { 0x00, 0x77 },
-          { 0x00, 0x78 }, { 0x00, 0x79 }, { 0x00, 0x7A }, { 0x00, 0xE4 },
-          { 0x00, 0xF6 }, { 0x00, 0xF1 }, { 0x00, 0xFC }, { 0x00, 0xE0 } }
-    };
-
-    static constexpr std::array<word, 128> extended_gsm_03_38_to_ucs2 = {
-        { { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x0C }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x5E }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x7B }, { 0x00, 0x7D }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x5C },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x5B }, { 0x00, 0x7E }, { 0x00, 0x5D }, { 0x00, 0x20 },
-          { 0x00, 0x7C }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x20, 0xAC }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 },
-          { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 }, { 0x00, 0x20 } }
-    };
+    const auto& locking =
+        detail::gsm_locking_shift_table(alphabet.locking_shift);
+    const auto& single = detail::gsm_single_shift_table(alphabet.single_shift);
 
     std::string ucs2;
+    ucs2.reserve(body.size() * 2);
     bool extended = false;
 
     for(const auto& septet : body)
@@ -98,16 +44,18 @@ convert_gsm_to_ucs2(std::string_view body)
         if(static_cast<uint8_t>(septet) > 127)
             continue;
 
-        if(!extended && septet == 0x1B)
+        if(!extended && septet == detail::gsm_escape)
         {
             extended = true;
             continue;
         }
 
-        const auto [h, l] = extended
-            ? extended_gsm_03_38_to_ucs2[static_cast<uint8_t>(septet)]
-            : gsm_03_38_to_ucs2[static_cast<uint8_t>(septet)];
-        ucs2.append({ static_cast<char>(h), static_cast<char>(l) });
+        auto cp = extended ? single[static_cast<uint8_t>(septet)]
+                           : locking[static_cast<uint8_t>(septet)];
+        if(cp == 0)
+            cp = 0x20;
+        ucs2.append(
+            { static_cast<char>(cp >> 8), static_cast<char>(cp & 0xFF) });
 
         extended = false;
     }
@@ -125,4 +73,349 @@ convert_ascii_to_ucs2(std::string_view body)
 
     return ucs2;
 }
+
+namespace detail
+{
+// Decodes one code point and advances p, throws on invalid UTF-8
+inline char32_t
+decode_utf8(const uint8_t*& p, const uint8_t* end)
+{
+    const auto b0 = *p++;
+    if(b0 < 0x80)
+        return b0;
+
+    auto size = 0;
+    auto cp   = char32_t{};
+    auto min  = char32_t{};
+    if((b0 & 0xE0) == 0xC0)
+    {
+        size = 1;
+        cp   = b0 & 0x1F;
+        min  = 0x80;
+    }
+    else if((b0 & 0xF0) == 0xE0)
+    {
+        size = 2;
+        cp   = b0 & 0x0F;
+        min  = 0x800;
+    }
+    else if((b0 & 0xF8) == 0xF0)
+    {
+        size = 3;
+        cp   = b0 & 0x07;
+        min  = 0x10000;
+    }
+    else
+    {
+        throw std::invalid_argument{ "invalid UTF-8 leading octet" };
+    }
+
+    if(end - p < size)
+        throw std::invalid_argument{ "truncated UTF-8 sequence" };
+
+    for(auto i = 0; i < size; i++)
+    {
+        if((p[i] & 0xC0) != 0x80)
+            throw std::invalid_argument{ "invalid UTF-8 continuation" };
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    p += size;
+
+    if(cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        throw std::invalid_argument{ "invalid UTF-8 code point" };
+
+    return cp;
+}
+} // namespace detail
+
+/// Return the maximum number of octets that converting UTF-8 to UCS-2 needs
+constexpr std::size_t
+max_ucs2_size(std::size_t utf8_size) noexcept
+{
+    return utf8_size * 2;
+}
+
+/// Return the maximum number of octets that converting UCS-2 to UTF-8 needs
+constexpr std::size_t
+max_utf8_size(std::size_t ucs2_size) noexcept
+{
+    return ucs2_size / 2 * 3;
+}
+
+/// Convert UTF-8 to big-endian UCS-2
+/**
+ * Code points outside the basic multilingual plane are encoded as UTF-16
+ * surrogate pairs. Throws std::invalid_argument on invalid UTF-8, including
+ * overlong forms, encoded surrogates and truncated sequences.
+ *
+ * @return The number of octets written.
+ *
+ * @param utf8 The UTF-8 input
+ * @param out The output buffer, it should have room for
+ * max_ucs2_size(utf8.size()) octets
+ */
+inline std::size_t
+convert_utf8_to_ucs2(std::string_view utf8, char* out)
+{
+    const auto* p   = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* end = p + utf8.size();
+    auto* o         = out;
+
+    auto put = [&](uint32_t u)
+    {
+        *o++ = static_cast<char>(u >> 8);
+        *o++ = static_cast<char>(u & 0xFF);
+    };
+
+    while(p != end)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        // ASCII fast path, 16 octets at a time
+        const auto zero = _mm_setzero_si128();
+        while(end - p >= 16)
+        {
+            const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if(_mm_movemask_epi8(x) != 0)
+                break;
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(o), _mm_unpacklo_epi8(zero, x));
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(o + 16), _mm_unpackhi_epi8(zero, x));
+            p += 16;
+            o += 32;
+        }
+        if(p == end)
+            break;
+#endif
+        const auto cp = detail::decode_utf8(p, end);
+
+        if(cp >= 0x10000)
+        {
+            put(0xD800 | ((cp - 0x10000) >> 10));
+            put(0xDC00 | ((cp - 0x10000) & 0x3FF));
+        }
+        else
+        {
+            put(cp);
+        }
+    }
+
+    return static_cast<std::size_t>(o - out);
+}
+
+/// Convert UTF-8 to big-endian UCS-2
+/**
+ * See the buffer overload of convert_utf8_to_ucs2.
+ */
+inline std::string
+convert_utf8_to_ucs2(std::string_view utf8)
+{
+    auto ucs2 = std::string(max_ucs2_size(utf8.size()), '\0');
+    ucs2.resize(convert_utf8_to_ucs2(utf8, ucs2.data()));
+    return ucs2;
+}
+
+/// Convert big-endian UCS-2 to UTF-8
+/**
+ * The input is treated as UTF-16, surrogate pairs are decoded into code
+ * points outside the basic multilingual plane. Throws std::length_error if
+ * the input has an odd length and std::invalid_argument on unpaired
+ * surrogates.
+ *
+ * @return The number of octets written.
+ *
+ * @param ucs2 The big-endian UCS-2 input
+ * @param out The output buffer, it should have room for
+ * max_utf8_size(ucs2.size()) octets
+ */
+inline std::size_t
+convert_ucs2_to_utf8(std::string_view ucs2, char* out)
+{
+    if(ucs2.size() % 2 != 0)
+        throw std::length_error{ "UCS-2 length is odd" };
+
+    const auto* p   = reinterpret_cast<const uint8_t*>(ucs2.data());
+    const auto* end = p + ucs2.size();
+    auto* o         = out;
+
+    while(p != end)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        // ASCII fast path, 16 code units at a time
+        const auto mask = _mm_set1_epi16(static_cast<short>(0x80FF));
+        while(end - p >= 32)
+        {
+            const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const auto b =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+            const auto non_ascii = _mm_or_si128(
+                _mm_and_si128(a, mask), _mm_and_si128(b, mask));
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                   non_ascii, _mm_setzero_si128())) != 0xFFFF)
+                break;
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(o),
+                _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+            p += 32;
+            o += 16;
+        }
+        if(p == end)
+            break;
+#endif
+        auto cp = static_cast<uint32_t>(p[0] << 8 | p[1]);
+        p += 2;
+
+        if(cp >= 0xD800 && cp <= 0xDFFF)
+        {
+            if(cp >= 0xDC00 || end - p < 2)
+                throw std::invalid_argument{ "unpaired UTF-16 surrogate" };
+
+            const auto low = static_cast<uint32_t>(p[0] << 8 | p[1]);
+            if(low < 0xDC00 || low > 0xDFFF)
+                throw std::invalid_argument{ "unpaired UTF-16 surrogate" };
+            p += 2;
+
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        if(cp < 0x80)
+        {
+            *o++ = static_cast<char>(cp);
+        }
+        else if(cp < 0x800)
+        {
+            *o++ = static_cast<char>(0xC0 | (cp >> 6));
+            *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if(cp < 0x10000)
+        {
+            *o++ = static_cast<char>(0xE0 | (cp >> 12));
+            *o++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            *o++ = static_cast<char>(0xF0 | (cp >> 18));
+            *o++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *o++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    return static_cast<std::size_t>(o - out);
+}
+
+/// Convert big-endian UCS-2 to UTF-8
+/**
+ * See the buffer overload of convert_ucs2_to_utf8.
+ */
+inline std::string
+convert_ucs2_to_utf8(std::string_view ucs2)
+{
+    auto utf8 = std::string(max_utf8_size(ucs2.size()), '\0');
+    utf8.resize(convert_ucs2_to_utf8(ucs2, utf8.data()));
+    return utf8;
+}
+
+/// Return the maximum number of septets that converting UTF-8 to GSM needs
+constexpr std::size_t
+max_gsm_size(std::size_t utf8_size) noexcept
+{
+    return utf8_size * 2;
+}
+
+/// Convert UTF-8 to unpacked GSM 03.38 septets
+/**
+ * Characters of the extension table are written as an escape septet followed
+ * by their septet. Throws std::invalid_argument on invalid UTF-8 and on
+ * characters that are not in the alphabet.
+ *
+ * @return The number of septets written.
+ *
+ * @param utf8 The UTF-8 input
+ * @param out The output buffer, it should have room for
+ * max_gsm_size(utf8.size()) octets
+ * @param transliterate Replace characters that are not in the alphabet with
+ * similar ones that are, like smart quotes with ASCII quotes
+ * @param alphabet The national language tables to encode with, the user data
+ * header should carry them, see user_data_header::set_gsm_alphabet
+ */
+inline std::size_t
+convert_utf8_to_gsm(
+    std::string_view utf8,
+    char* out,
+    bool transliterate    = false,
+    gsm_alphabet alphabet = {})
+{
+    const auto* p   = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* end = p + utf8.size();
+    auto* o         = out;
+
+    auto put = [&](char32_t cp)
+    {
+        const auto septet = detail::find_gsm_septet(alphabet, cp);
+        if(septet == detail::gsm_not_found)
+            return false;
+        if(septet > 0xFF)
+            *o++ = static_cast<char>(detail::gsm_escape);
+        *o++ = static_cast<char>(septet & 0x7F);
+        return true;
+    };
+
+    while(p != end)
+    {
+        const auto cp = detail::decode_utf8(p, end);
+        if(put(cp))
+            continue;
+
+        const auto replacement =
+            transliterate ? detail::find_transliteration(cp) : "";
+        if(replacement.empty())
+            throw std::invalid_argument{ "character is not in GSM alphabet" };
+
+        for(auto c : replacement)
+            put(static_cast<char32_t>(c));
+    }
+
+    return static_cast<std::size_t>(o - out);
+}
+
+/// Convert UTF-8 to unpacked GSM 03.38 septets
+/**
+ * See the buffer overload of convert_utf8_to_gsm.
+ */
+inline std::string
+convert_utf8_to_gsm(
+    std::string_view utf8,
+    bool transliterate    = false,
+    gsm_alphabet alphabet = {})
+{
+    auto gsm = std::string(max_gsm_size(utf8.size()), '\0');
+    gsm.resize(convert_utf8_to_gsm(utf8, gsm.data(), transliterate, alphabet));
+    return gsm;
+}
+
+/// Convert UTF-8 to ISO 8859-1
+/**
+ * Throws std::invalid_argument on invalid UTF-8 and on characters that are
+ * not in ISO 8859-1.
+ */
+inline std::string
+convert_utf8_to_latin1(std::string_view utf8)
+{
+    const auto* p   = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* end = p + utf8.size();
+
+    std::string latin1;
+    latin1.reserve(utf8.size());
+    while(p != end)
+    {
+        const auto cp = detail::decode_utf8(p, end);
+        if(cp > 0xFF)
+            throw std::invalid_argument{ "character is not in ISO 8859-1" };
+        latin1.push_back(static_cast<char>(cp));
+    }
+
+    return latin1;
+}
 } // namespace smpp
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// Builds a prefix_table of random prefixes, a million by default, and measures
+// the time of building it and of looking up random dest_addrs through it.
+//
+// Usage: prefix_router_benchmark [prefixes] [lookups]
+
+#include <smpp/net/prefix_router.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+std::string
+random_digits(std::mt19937_64& rng, std::size_t min, std::size_t max)
+{
+    auto length = std::uniform_int_distribution<std::size_t>{ min, max }(rng);
+    auto digit  = std::uniform_int_distribution<int>{ '0', '9' };
+    auto result = std::string(length, '0');
+    for(auto& c : result)
+        c = static_cast<char>(digit(rng));
+    return result;
+}
+
+double
+nanoseconds_since(clock_type::time_point start, std::size_t count)
+{
+    const auto elapsed = std::chrono::duration<double, std::nano>{
+        clock_type::now() - start
+    };
+    return elapsed.count() / static_cast<double>(count);
+}
+
+int
+main(int argc, const char* argv[])
+{
+    const auto prefixes = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    const auto lookups  = argc > 2 ? std::stoul(argv[2]) : 10'000'000;
+
+    auto rng   = std::mt19937_64{ 2775 };
+    auto rules = std::vector<smpp::prefix_table<uint32_t>::rule>{};
+    rules.reserve(prefixes);
+    for(auto i = std::size_t{}; i < prefixes; i++)
+        rules.push_back({ .prefix = random_digits(rng, 4, 9),
+                          .target = static_cast<uint32_t>(i % 64) });
+
+    // dest_addrs are generated up front, so only lookups are timed
+    auto dest_addrs = std::vector<std::string>{};
+    dest_addrs.reserve(1 << 16);
+    for(auto i = 0; i < 1 << 16; i++)
+        dest_addrs.push_back(random_digits(rng, 10, 12));
+
+    auto start  = clock_type::now();
+    auto router = smpp::prefix_router<uint32_t>{ smpp::prefix_table<uint32_t>{
+        std::move(rules) } };
+    std::cout << "build:            " << nanoseconds_since(start, 1) / 1e6
+              << "ms for " << router.table()->size() << " prefixes\n";
+
+    constexpr auto ton = smpp::ton::international;
+    constexpr auto npi = smpp::npi::e164;
+
+    auto reader = smpp::prefix_router<uint32_t>::reader{ router };
+
+    // all dest_addrs walk the whole trie, most nodes miss the caches, while
+    // the first 1024 dest_addrs stand for traffic to popular prefixes
+    for(auto [name, mask] : { std::pair{ "lookup (uniform): ", 0xffff },
+                              std::pair{ "lookup (hot):     ", 0x3ff } })
+    {
+        auto matched = std::size_t{};
+        start        = clock_type::now();
+        for(auto i = std::size_t{}; i < lookups; i++)
+            if(reader.lookup(ton, npi, dest_addrs[i & mask]))
+                matched++;
+        std::cout << name << nanoseconds_since(start, lookups) << "ns, "
+                  << matched << " of " << lookups << " matched\n";
+    }
+
+    start = clock_type::now();
+    router.update(smpp::prefix_table<uint32_t>{});
+    reader.lookup(ton, npi, dest_addrs[0]);
+    std::cout << "update:           " << nanoseconds_since(start, 1) / 1e6
+              << "ms\n";
+}
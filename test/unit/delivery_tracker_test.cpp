@@ -0,0 +1,226 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <filesystem>
+
+namespace asio = boost::asio;
+using namespace asio::experimental::awaitable_operators;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(delivery_tracker)
+
+BOOST_AUTO_TEST_CASE(track_and_expire)
+{
+    auto ctx     = asio::io_context{};
+    auto tracker = smpp::delivery_tracker{ ctx.get_executor(), 1000 };
+    auto now     = smpp::delivery_tracker::clock::now();
+
+    for(auto i = 0; i < 1000; i++)
+        tracker.track(std::to_string(i), i, 10s + i * 1s, now);
+    BOOST_CHECK_EQUAL(tracker.size(), 1000);
+    BOOST_CHECK_THROW(tracker.track("full", 0, 10s, now), std::length_error);
+
+    BOOST_CHECK(tracker.find("42", now) == 42u);
+    BOOST_CHECK(tracker.untrack("42"));
+    BOOST_CHECK(!tracker.find("42", now));
+    BOOST_CHECK(!tracker.untrack("42"));
+
+    tracker.expire(now + 510s);
+    BOOST_CHECK_EQUAL(tracker.size(), 499);
+    for(auto i = 0; i < 1000; i++)
+        BOOST_CHECK(
+            tracker.find(std::to_string(i), now).has_value() == (i > 500));
+
+    auto receipt = smpp::deliver_sm{
+        .esm_class     = { .message_type =
+                           smpp::message_type::delivery_receipt },
+        .short_message = "id:999 sub:001 dlvrd:001 submit date:2301021504 "
+                         "done date:2301021505 stat:DELIVRD err:000 text:"
+    };
+    auto delivered = uint64_t{};
+    tracker.set_delivery_handler(
+        [&](uint64_t context, const smpp::delivery_receipt& r)
+        {
+            delivered = context;
+            BOOST_CHECK(r.state == smpp::message_state::delivered);
+        });
+    BOOST_CHECK(tracker.on_delivery_receipt(receipt));
+    BOOST_CHECK_EQUAL(delivered, 999);
+    BOOST_CHECK(!tracker.on_delivery_receipt(receipt));
+}
+
+BOOST_AUTO_TEST_CASE(early_receipt)
+{
+    auto ctx     = asio::io_context{};
+    auto tracker = smpp::delivery_tracker{ ctx.get_executor(), 100 };
+
+    const auto receipt = smpp::deliver_sm{
+        .esm_class     = { .message_type =
+                           smpp::message_type::delivery_receipt },
+        .short_message = "id:A1 stat:REJECTD err:042 text:"
+    };
+    auto delivered = uint64_t{};
+    tracker.set_delivery_handler(
+        [&](uint64_t context, const smpp::delivery_receipt& r)
+        {
+            delivered = context;
+            BOOST_CHECK(r.id == "A1");
+            BOOST_CHECK(r.error == "042");
+        });
+
+    BOOST_CHECK(!tracker.on_delivery_receipt(receipt));
+    tracker.track("A1", 7, 1h);
+    BOOST_CHECK_EQUAL(tracker.size(), 1);
+
+    ctx.run();
+    BOOST_CHECK_EQUAL(delivered, 7);
+    BOOST_CHECK_EQUAL(tracker.size(), 0);
+
+    // a receipt that is too old to be replayed
+    const auto now = smpp::delivery_tracker::clock::now();
+    BOOST_CHECK(!tracker.on_delivery_receipt(receipt, now - 1min));
+    tracker.track("A1", 8, 1h, now);
+    ctx.restart();
+    ctx.run();
+    BOOST_CHECK_EQUAL(delivered, 7);
+    BOOST_CHECK_EQUAL(tracker.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(memory_mapped)
+{
+    const auto path =
+        (std::filesystem::temp_directory_path() / "smpp_delivery_tracker")
+            .string();
+    std::remove(path.c_str());
+
+    auto ctx = asio::io_context{};
+    {
+        auto tracker = smpp::delivery_tracker{ ctx.get_executor(), 100, path };
+        tracker.track("persisted", 7, 1h);
+    }
+    {
+        auto tracker = smpp::delivery_tracker{ ctx.get_executor(), 100, path };
+        BOOST_CHECK_EQUAL(tracker.size(), 1);
+        BOOST_CHECK(tracker.find("persisted") == 7u);
+    }
+    {
+        // another layout starts empty
+        auto tracker = smpp::delivery_tracker{ ctx.get_executor(), 1000, path };
+        BOOST_CHECK_EQUAL(tracker.size(), 0);
+        for(auto i = 0; i < 1000; i++)
+            tracker.track(std::to_string(i), i, 1h);
+    }
+    {
+        // the same layout with fewer entries than the file has starts empty
+        auto tracker = smpp::delivery_tracker{ ctx.get_executor(), 900, path };
+        BOOST_CHECK_EQUAL(tracker.size(), 0);
+        for(auto i = 0; i < 900; i++)
+            tracker.track(std::to_string(i), i, 1h);
+        BOOST_CHECK_THROW(tracker.track("full", 0, 1h), std::length_error);
+        BOOST_CHECK(tracker.find("899") == 899u);
+    }
+
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(async_wait_delivery)
+{
+    auto executed = 0;
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        co_await session.async_send(
+            smpp::submit_sm_resp{ .message_id = "A1" },
+            seq_num,
+            smpp::command_status::rok);
+
+        // the receipt arrives before the client has tracked the message
+        co_await session.async_send(smpp::deliver_sm{
+            .esm_class     = { .message_type =
+                               smpp::message_type::delivery_receipt },
+            .short_message = "id:A1 stat:UNDELIV err:001 text:" });
+
+        std::tie(pdu, seq_num, status) = co_await session.async_receive();
+        BOOST_CHECK(std::holds_alternative<smpp::deliver_sm_resp>(pdu));
+
+        co_await session.async_send_unbind();
+        std::tie(pdu, seq_num, status) = co_await session.async_receive(
+            asio::as_tuple(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto tracker  = smpp::delivery_tracker{ executor, 100 };
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+        session.set_delivery_tracker(&tracker);
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            for(;;)
+            {
+                auto [ec, pdu, seq_num, status] =
+                    co_await session.async_receive(
+                        asio::as_tuple(asio::use_awaitable));
+                if(ec)
+                    co_return;
+
+                if(std::holds_alternative<smpp::deliver_sm>(pdu))
+                    co_await session.async_send(
+                        smpp::deliver_sm_resp{},
+                        seq_num,
+                        smpp::command_status::rok);
+            }
+        };
+
+        auto request = [&]() -> asio::awaitable<void>
+        {
+            auto submit_sm     = smpp::submit_sm{ .dest_addr = "1234" };
+            auto [pdu, status] = co_await session.async_request(submit_sm);
+            const auto message_id =
+                std::get<smpp::submit_sm_resp>(pdu).message_id;
+            tracker.track(message_id, 1, 1h);
+
+            auto state = co_await tracker.async_wait_delivery(message_id);
+            BOOST_CHECK(state == smpp::message_state::undeliverable);
+            BOOST_CHECK_EQUAL(tracker.size(), 0);
+
+            auto [ec, _] = co_await tracker.async_wait_delivery(
+                message_id, asio::as_tuple(asio::use_awaitable));
+            BOOST_CHECK(ec == smpp::error::delivery_not_tracked);
+        };
+
+        co_await (receive() && request());
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run();
+
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,222 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace asio = boost::asio;
+using namespace std::chrono_literals;
+
+namespace
+{
+// An endpoint that responds to each request after a delay, or times out
+struct fake_endpoint
+{
+    asio::steady_timer timer;
+    std::chrono::steady_clock::duration delay{ 1ms };
+    smpp::command_status status{ smpp::command_status::rok };
+    std::chrono::steady_clock::duration rtt{};
+    int requests{};
+
+    explicit fake_endpoint(const asio::any_io_executor& executor)
+        : timer{ executor }
+    {
+    }
+
+    asio::any_io_executor
+    get_executor() noexcept
+    {
+        return timer.get_executor();
+    }
+
+    std::chrono::steady_clock::duration
+    enquire_link_rtt() const noexcept
+    {
+        return rtt;
+    }
+
+    template<typename CompletionToken>
+    auto
+    async_request(
+        const smpp::request_pdu auto&,
+        std::chrono::steady_clock::duration response_timeout,
+        CompletionToken&& token)
+    {
+        requests++;
+        return asio::async_compose<
+            CompletionToken,
+            void(
+                boost::system::error_code,
+                smpp::pdu_variant,
+                smpp::command_status)>(
+            [this, response_timeout, c = asio::coroutine{}](
+                auto&& self, boost::system::error_code ec = {}) mutable
+            {
+                BOOST_ASIO_CORO_REENTER(c)
+                {
+                    timer.expires_after(std::min(delay, response_timeout));
+                    BOOST_ASIO_CORO_YIELD
+                    timer.async_wait(std::move(self));
+                    if(ec)
+                        return self.complete(ec, {}, {});
+                    if(delay > response_timeout)
+                        return self.complete(
+                            smpp::error::response_timeout, {}, {});
+                    self.complete(ec, smpp::submit_sm_resp{}, status);
+                }
+            },
+            token,
+            timer);
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(endpoint_router)
+
+BOOST_AUTO_TEST_CASE(failover)
+{
+    auto executed = 0;
+    auto ctx      = asio::io_context{};
+    auto a        = fake_endpoint{ ctx.get_executor() };
+    auto b        = fake_endpoint{ ctx.get_executor() };
+    auto router   = smpp::endpoint_router<fake_endpoint>{
+        { &a, &b }, 50ms, { .failure_threshold = 1, .open_duration = 1h }
+    };
+
+    router.selector().record_rtt(0, 10ms);
+    router.selector().record_rtt(1, 20ms);
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto request = [&]()
+        {
+            return router.async_request(
+                smpp::submit_sm{}, asio::as_tuple(asio::use_awaitable));
+        };
+
+        // a fails with rsyserr and its circuit opens
+        a.status = smpp::command_status::rsyserr;
+
+        auto [ec, pdu, status] = co_await request();
+        BOOST_CHECK(!ec);
+        BOOST_CHECK(status == smpp::command_status::rsyserr);
+        BOOST_CHECK_EQUAL(a.requests, 1);
+        BOOST_CHECK(router.selector().state(0) == smpp::circuit_state::open);
+
+        // the next request fails over to b
+        std::tie(ec, pdu, status) = co_await request();
+        BOOST_CHECK(!ec);
+        BOOST_CHECK(status == smpp::command_status::rok);
+        BOOST_CHECK(std::holds_alternative<smpp::submit_sm_resp>(pdu));
+        BOOST_CHECK_EQUAL(b.requests, 1);
+
+        // b doesn't respond in time and its circuit opens
+        b.delay                   = 1h;
+        std::tie(ec, pdu, status) = co_await request();
+        BOOST_CHECK(ec == smpp::error::response_timeout);
+        BOOST_CHECK_EQUAL(b.requests, 2);
+        BOOST_CHECK(router.selector().state(1) == smpp::circuit_state::open);
+
+        // all the circuits are open
+        std::tie(ec, pdu, status) = co_await request();
+        BOOST_CHECK(ec == smpp::error::no_healthy_endpoint);
+        BOOST_CHECK_EQUAL(a.requests, 1);
+        BOOST_CHECK_EQUAL(b.requests, 2);
+
+        executed++;
+    };
+
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 1);
+}
+
+BOOST_AUTO_TEST_CASE(retry)
+{
+    auto executed = 0;
+    auto ctx      = asio::io_context{};
+    auto a        = fake_endpoint{ ctx.get_executor() };
+    auto b        = fake_endpoint{ ctx.get_executor() };
+    auto router   = smpp::endpoint_router<fake_endpoint>{ { &a, &b }, 50ms };
+
+    router.selector().record_rtt(0, 10ms);
+    router.selector().record_rtt(1, 100ms);
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto request = [&]()
+        {
+            return router.async_request(
+                smpp::submit_sm{}, asio::as_tuple(asio::use_awaitable));
+        };
+
+        // a response is not retried, whatever its command_status is
+        a.status               = smpp::command_status::rsyserr;
+        auto [ec, pdu, status] = co_await request();
+        BOOST_CHECK(!ec);
+        BOOST_CHECK(status == smpp::command_status::rsyserr);
+        BOOST_CHECK_EQUAL(a.requests, 1);
+        BOOST_CHECK_EQUAL(b.requests, 0);
+
+        // a doesn't respond in time and the request is retried on b
+        a.delay                   = 1h;
+        std::tie(ec, pdu, status) = co_await request();
+        BOOST_CHECK(!ec);
+        BOOST_CHECK(status == smpp::command_status::rok);
+        BOOST_CHECK_EQUAL(a.requests, 2);
+        BOOST_CHECK_EQUAL(b.requests, 1);
+
+        // the retry is done only once
+        b.delay                   = 1h;
+        std::tie(ec, pdu, status) = co_await request();
+        BOOST_CHECK(ec == smpp::error::response_timeout);
+        BOOST_CHECK_EQUAL(a.requests + b.requests, 5);
+
+        executed++;
+    };
+
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 1);
+}
+
+BOOST_AUTO_TEST_CASE(enquire_link_rtt)
+{
+    auto executed = 0;
+    auto ctx      = asio::io_context{};
+    auto a        = fake_endpoint{ ctx.get_executor() };
+    auto b        = fake_endpoint{ ctx.get_executor() };
+    auto router   = smpp::endpoint_router<fake_endpoint>{ { &a, &b } };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        // the enquire_link RTTs are recorded and b is faster
+        a.rtt = 30ms;
+        b.rtt = 10ms;
+        co_await router.async_request(smpp::submit_sm{}, asio::use_awaitable);
+        BOOST_CHECK(router.selector().rtt(0) == 30ms);
+        BOOST_CHECK_EQUAL(a.requests, 0);
+        BOOST_CHECK_EQUAL(b.requests, 1);
+
+        // a slow enquire_link of b moves the traffic to a
+        b.rtt = 1h;
+        co_await router.async_request(smpp::submit_sm{}, asio::use_awaitable);
+        BOOST_CHECK(router.selector().rtt(1) > 30ms);
+        BOOST_CHECK_EQUAL(a.requests, 1);
+        BOOST_CHECK_EQUAL(b.requests, 1);
+
+        executed++;
+    };
+
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
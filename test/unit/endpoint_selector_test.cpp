@@ -0,0 +1,79 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(endpoint_selector)
+
+BOOST_AUTO_TEST_CASE(lowest_rtt)
+{
+    auto selector = smpp::endpoint_selector{ 3 };
+
+    selector.record_success(0, 30ms);
+    selector.record_success(1, 10ms);
+    selector.record_success(2, 20ms);
+    BOOST_CHECK_EQUAL(*selector.select(), 1);
+
+    // errors inflate the RTT of an endpoint
+    selector.record_failure(1);
+    selector.record_failure(1);
+    selector.record_failure(1);
+    BOOST_CHECK_EQUAL(*selector.select(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(circuit_breaking)
+{
+    auto options     = smpp::circuit_breaker_options{ .failure_threshold = 2,
+                                                      .open_duration = 100ms };
+    auto selector    = smpp::endpoint_selector{ 2, options };
+    const auto start = smpp::endpoint_selector::clock::now();
+
+    selector.record_success(0, 10ms);
+    selector.record_success(1, 20ms);
+    selector.record_failure(0, start);
+    BOOST_CHECK(selector.state(0, start) == smpp::circuit_state::closed);
+    selector.record_failure(0, start);
+    BOOST_CHECK(selector.state(0, start) == smpp::circuit_state::open);
+    BOOST_CHECK_EQUAL(*selector.select(start), 1);
+
+    selector.record_failure(1, start);
+    selector.record_failure(1, start);
+    BOOST_CHECK(!selector.select(start));
+
+    // after open_duration a single probe is let through
+    const auto later = start + 100ms;
+    BOOST_CHECK(selector.state(0, later) == smpp::circuit_state::half_open);
+    BOOST_CHECK_EQUAL(*selector.select(later), 0);
+    BOOST_CHECK_EQUAL(*selector.select(later), 1);
+    BOOST_CHECK(!selector.select(later));
+
+    selector.record_success(0, 10ms);
+    BOOST_CHECK(selector.state(0, later) == smpp::circuit_state::closed);
+    BOOST_CHECK_EQUAL(*selector.select(later), 0);
+}
+
+BOOST_AUTO_TEST_CASE(unmeasured)
+{
+    auto selector = smpp::endpoint_selector{ 3 };
+
+    // without any RTT sample the error rates decide
+    selector.record_failure(0);
+    BOOST_CHECK_EQUAL(*selector.select(), 1);
+
+    // an unmeasured endpoint gets the mean RTT of the measured ones
+    selector.record_success(0, 30ms);
+    selector.record_success(1, 10ms);
+    BOOST_CHECK_EQUAL(*selector.select(), 1);
+    selector.record_failure(1);
+    selector.record_failure(1);
+    BOOST_CHECK_EQUAL(*selector.select(), 2);
+    selector.record_failure(2);
+    BOOST_CHECK_EQUAL(*selector.select(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
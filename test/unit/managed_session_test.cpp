@@ -0,0 +1,86 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace asio = boost::asio;
+using namespace asio::experimental::awaitable_operators;
+
+BOOST_AUTO_TEST_SUITE(managed_session)
+
+BOOST_AUTO_TEST_CASE(replay_after_reconnect)
+{
+    auto executed = 0;
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+
+        for(auto i = 0; i < 2; i++)
+        {
+            auto session = smpp::session{ co_await acceptor.async_accept() };
+
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(
+                std::get<smpp::bind_transceiver>(pdu).system_id == "managed");
+            co_await session.async_send(
+                smpp::bind_transceiver_resp{},
+                seq_num,
+                smpp::command_status::rok);
+
+            std::tie(pdu, seq_num, status) = co_await session.async_receive();
+            BOOST_CHECK(std::get<smpp::submit_sm>(pdu).dest_addr == "1234");
+
+            // the first connection dies before responding
+            if(i == 0)
+                continue;
+
+            co_await session.async_send(
+                smpp::submit_sm_resp{ .message_id = "1" },
+                seq_num,
+                smpp::command_status::rok);
+        }
+
+        executed++;
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto session  = smpp::managed_session{ executor,
+                                              { asio::ip::tcp::v4(), 2775 },
+                                              smpp::bind_transceiver{
+                                                  .system_id = "managed" } };
+
+        auto request = [&]() -> asio::awaitable<void>
+        {
+            auto submit_sm     = smpp::submit_sm{ .dest_addr = "1234" };
+            auto [pdu, status] = co_await session.async_request(submit_sm);
+            BOOST_CHECK(
+                std::get<smpp::submit_sm_resp>(pdu).message_id == "1");
+            BOOST_CHECK(status == smpp::command_status::rok);
+            BOOST_CHECK_EQUAL(session.outstanding_requests(), 0);
+        };
+
+        co_await (request() || session.async_run(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
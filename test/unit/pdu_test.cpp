@@ -180,6 +180,60 @@ BOOST_AUTO_TEST_CASE(serialize_deserialize)
         .oparam                  = oparam,
     });
 
+    auto dest_addresses = smpp::dest_address_list{};
+    dest_addresses.add_sme_address(
+        smpp::ton::international, smpp::npi::e164, "989123456789");
+    dest_addresses.add_distribution_list("customers");
+
+    check(smpp::submit_multi{
+        .service_type    = "IO",
+        .source_addr_ton = smpp::ton::alphanumeric,
+        .source_addr_npi = smpp::npi::unknown,
+        .source_addr     = "SENDER",
+        .dest_addresses  = dest_addresses,
+        .priority_flag   = smpp::priority_flag::gsm_priority,
+        .validity_period = "000001000000000R",
+        .data_coding     = smpp::data_coding::ucs2,
+        .short_message   = "JFD:JU9458349gd;lfjgdfljg'dfgs'd",
+        .oparam          = oparam,
+    });
+
+    auto broadcast_oparam = smpp::oparam{};
+    broadcast_oparam.set_as_string(
+        smpp::oparam_tag::message_payload, "Tsunami warning");
+    broadcast_oparam.add_as_string(
+        smpp::oparam_tag::broadcast_area_identifier, { "\x00" "area1", 6 });
+    broadcast_oparam.add_as_string(
+        smpp::oparam_tag::broadcast_area_identifier, { "\x00" "area2", 6 });
+    broadcast_oparam.set_as_string(
+        smpp::oparam_tag::broadcast_rep_num, { "\x00\x05", 2 });
+
+    check(smpp::broadcast_sm{
+        .source_addr_ton        = smpp::ton::alphanumeric,
+        .source_addr            = "ALERT",
+        .message_id             = "BC1",
+        .priority_flag          = smpp::priority_flag::gsm_priority,
+        .schedule_delivery_time = "000000000100000R",
+        .data_coding            = smpp::data_coding::ucs2,
+        .oparam                 = broadcast_oparam,
+    });
+
+    check(smpp::broadcast_sm_resp{ .message_id = "BC1", .oparam = oparam });
+
+    check(smpp::query_broadcast_sm{ .message_id      = "BC1",
+                                    .source_addr_ton = smpp::ton::alphanumeric,
+                                    .source_addr     = "ALERT" });
+
+    check(smpp::query_broadcast_sm_resp{ .message_id = "BC1",
+                                         .oparam     = broadcast_oparam });
+
+    check(smpp::cancel_broadcast_sm{ .service_type = "CB",
+                                     .message_id   = "BC1",
+                                     .source_addr  = "ALERT",
+                                     .oparam       = oparam });
+
+    check(smpp::cancel_broadcast_sm_resp{});
+
     check(smpp::cancel_sm_resp{});
 
     check(smpp::data_sm_resp{ .message_id = "JKYW0986", .oparam = oparam });
@@ -196,6 +250,84 @@ BOOST_AUTO_TEST_CASE(serialize_deserialize)
     check(smpp::replace_sm_resp{});
 
     check(smpp::submit_sm_resp{ .message_id = "JSHDHSDA238904632" });
+
+    auto unsuccess_smes = smpp::unsuccess_sme_list{};
+    unsuccess_smes.add(
+        smpp::ton::national,
+        smpp::npi::national,
+        "09123456789",
+        smpp::command_status::rinvdstadr);
+
+    check(smpp::submit_multi_resp{ .message_id     = "JSHDHSDA238904632",
+                                   .unsuccess_smes = unsuccess_smes });
+}
+
+BOOST_AUTO_TEST_CASE(repeated_oparam)
+{
+    using enum smpp::oparam_tag;
+
+    auto oparam = smpp::oparam{};
+    oparam.add_as_string(broadcast_area_identifier, "a");
+    oparam.add_as_string(broadcast_area_identifier, "b");
+    oparam.set_as_string(message_payload, "c");
+    BOOST_CHECK(oparam.get_as_string(broadcast_area_identifier) == "a");
+
+    auto buf = std::vector<uint8_t>{};
+    oparam.serialize(&buf);
+    auto span   = std::span<const uint8_t>{ buf };
+    auto parsed = smpp::oparam{ &span };
+    const auto areas = parsed.get_all_as_string(broadcast_area_identifier);
+    BOOST_REQUIRE_EQUAL(areas.size(), 2);
+    BOOST_CHECK(areas[0] == "a");
+    BOOST_CHECK(areas[1] == "b");
+
+    parsed.set_as_string(broadcast_area_identifier, "d");
+    BOOST_CHECK_EQUAL(
+        parsed.get_all_as_string(broadcast_area_identifier).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(submit_multi)
+{
+    auto pdu = smpp::submit_multi{};
+    pdu.dest_addresses.add_sme_address(
+        smpp::ton::international, smpp::npi::e164, "1234");
+    pdu.dest_addresses.add_distribution_list("dl");
+
+    auto buf = std::vector<uint8_t>{};
+    smpp::serialize_to(&buf, pdu);
+    // service_type, source_addr_ton, source_addr_npi and source_addr
+    const auto expected = std::vector<uint8_t>{
+        2, 1, 1, 1, '1', '2', '3', '4', 0, 2, 'd', 'l', 0
+    };
+    BOOST_CHECK(std::equal(
+        expected.begin(), expected.end(), buf.begin() + 4, buf.begin() + 17));
+
+    const auto parsed = smpp::deserialize<smpp::submit_multi>(buf);
+    auto it           = parsed.dest_addresses.begin();
+    BOOST_CHECK((*it).address == "1234");
+    BOOST_CHECK((*it).dest_addr_ton == smpp::ton::international);
+    BOOST_CHECK((*++it).dest_flag == smpp::dest_flag::distribution_list);
+    BOOST_CHECK((*it).address == "dl");
+    BOOST_CHECK(++it == parsed.dest_addresses.end());
+
+    for(auto i = pdu.dest_addresses.size(); i < 255; i++)
+        pdu.dest_addresses.add_sme_address(
+            smpp::ton::unknown, smpp::npi::unknown, std::to_string(i));
+    BOOST_CHECK_THROW(
+        pdu.dest_addresses.add_distribution_list("dl"), std::length_error);
+    BOOST_CHECK_THROW(
+        smpp::dest_address_list{}.add_distribution_list(
+            "a name longer than 20"),
+        std::length_error);
+
+    buf.clear();
+    smpp::serialize_to(&buf, pdu);
+    BOOST_CHECK(smpp::deserialize<smpp::submit_multi>(buf) == pdu);
+
+    // an invalid dest_flag
+    buf[4 + 9] = 3;
+    BOOST_CHECK_THROW(
+        smpp::deserialize<smpp::submit_multi>(buf), std::length_error);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+// Copyright (c) 2023 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(prefix_router)
+
+using table = smpp::prefix_table<int>;
+
+BOOST_AUTO_TEST_CASE(longest_prefix)
+{
+    const auto t = table{ { { .prefix = "", .target = 0 },
+                            { .prefix = "98", .target = 1 },
+                            { .prefix = "98912", .target = 2 },
+                            { .prefix = "989", .target = 3 },
+                            { .prefix = "44", .target = 4 },
+                            { .prefix = "989", .target = 5 } } };
+
+    constexpr auto ton = smpp::ton::international;
+    constexpr auto npi = smpp::npi::e164;
+
+    BOOST_CHECK_EQUAL(t.size(), 5u);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "989121234567"), 2);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "989131234567"), 5);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "9891"), 5);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "981"), 1);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "447700900123"), 4);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "1234"), 0);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, "98A12"), 1);
+    BOOST_CHECK_EQUAL(*t.lookup(ton, npi, ""), 0);
+
+    BOOST_CHECK(!table{}.lookup(ton, npi, "98"));
+    BOOST_CHECK_THROW(table{ { { .prefix = "+98" } } }, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(ton_and_npi)
+{
+    const auto t = table{
+        { { .prefix = "98", .target = 1 },
+          { .dest_addr_ton = smpp::ton::national, .prefix = "98", .target = 2 },
+          { .dest_addr_ton = smpp::ton::national,
+            .dest_addr_npi = smpp::npi::e164,
+            .prefix        = "9",
+            .target        = 3 },
+          { .dest_addr_npi = smpp::npi::e164, .prefix = "9", .target = 4 } }
+    };
+
+    using smpp::npi;
+    using smpp::ton;
+
+    BOOST_CHECK_EQUAL(*t.lookup(ton::international, npi::e164, "989"), 1);
+    BOOST_CHECK_EQUAL(*t.lookup(ton::national, npi::e164, "989"), 2);
+    BOOST_CHECK_EQUAL(*t.lookup(ton::national, npi::e164, "912"), 3);
+    BOOST_CHECK_EQUAL(*t.lookup(ton::unknown, npi::e164, "912"), 4);
+    BOOST_CHECK(!t.lookup(ton::unknown, npi::unknown, "912"));
+}
+
+BOOST_AUTO_TEST_CASE(update)
+{
+    auto router = smpp::prefix_router<int>{ table{ { { .prefix = "98",
+                                                       .target = 1 } } } };
+    auto reader = smpp::prefix_router<int>::reader{ router };
+
+    constexpr auto ton = smpp::ton::international;
+    constexpr auto npi = smpp::npi::e164;
+
+    BOOST_CHECK_EQUAL(*reader.lookup(ton, npi, "989"), 1);
+
+    const auto old = router.table();
+    router.update(table{ { { .prefix = "98", .target = 2 } } });
+    BOOST_CHECK_EQUAL(*reader.lookup(ton, npi, "989"), 2);
+    BOOST_CHECK_EQUAL(*old->lookup(ton, npi, "989"), 1);
+    BOOST_CHECK_EQUAL(old.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace asio = boost::asio;
+
+BOOST_AUTO_TEST_SUITE(relay)
+
+BOOST_AUTO_TEST_CASE(peek_dest_addr)
+{
+    auto body = std::vector<uint8_t>{};
+    smpp::serialize_to(
+        &body,
+        smpp::submit_sm{ .service_type = "CMT",
+                         .source_addr  = "5678",
+                         .dest_addr    = "1234" });
+
+    BOOST_CHECK(
+        smpp::peek_dest_addr(smpp::command_id::submit_sm, body) == "1234");
+    BOOST_CHECK(!smpp::peek_dest_addr(smpp::command_id::cancel_sm, body));
+
+    // up to the end of source_addr
+    const auto truncated = std::span{ body }.first(4 + 2 + 5);
+    BOOST_CHECK(!smpp::peek_dest_addr(smpp::command_id::submit_sm, truncated));
+}
+
+BOOST_AUTO_TEST_CASE(sequence_remap)
+{
+    auto remap = smpp::detail::sequence_remap<uint32_t>{ 256 };
+
+    // a request that is never answered doesn't grow the ring
+    remap.insert(1, 1);
+    for(auto key = uint32_t{ 2 }; key < 10'000; key++)
+    {
+        remap.insert(key, key);
+        BOOST_REQUIRE(remap.extract(key) == key);
+    }
+    BOOST_CHECK_EQUAL(remap.capacity(), 256);
+    BOOST_CHECK_EQUAL(remap.size(), 0);
+
+    // a window of outstanding requests does
+    for(auto key = uint32_t{ 10'000 }; key < 11'000; key++)
+        remap.insert(key, key);
+    BOOST_CHECK_EQUAL(remap.capacity(), 1024);
+    for(auto key = uint32_t{ 10'000 }; key < 11'000; key++)
+        BOOST_REQUIRE(remap.extract(key) == key);
+    BOOST_CHECK(!remap.extract(1));
+}
+
+BOOST_AUTO_TEST_CASE(forward_and_remap)
+{
+    auto executed = 0;
+
+    auto smsc = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        // the first request of the relay on this session
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        BOOST_CHECK(std::get<smpp::submit_sm>(pdu).dest_addr == "1234");
+        BOOST_CHECK_EQUAL(seq_num, 1u);
+        co_await session.async_send(
+            smpp::submit_sm_resp{ .message_id = "1" },
+            seq_num,
+            smpp::command_status::rok);
+
+        const auto deliver_seq_num =
+            co_await session.async_send(smpp::deliver_sm{ .dest_addr = "5" });
+        auto [resp, resp_seq_num, resp_status] =
+            co_await session.async_receive();
+        BOOST_CHECK(std::holds_alternative<smpp::deliver_sm_resp>(resp));
+        BOOST_CHECK_EQUAL(resp_seq_num, deliver_seq_num);
+
+        // the relay unbinds when the ESME unbinds
+        auto [ec, unbind, _, __] =
+            co_await session.async_receive(asio::as_tuple(asio::use_awaitable));
+        BOOST_CHECK(ec == smpp::error::unbinded);
+
+        executed++;
+    };
+
+    auto relay = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2776 });
+
+        auto upstream = std::make_shared<smpp::session>(
+            asio::ip::tcp::socket{ executor });
+        co_await upstream->next_layer().async_connect(
+            { asio::ip::tcp::v4(), 2775 });
+
+        auto proxy = smpp::relay{ std::make_shared<smpp::session>(
+                                      co_await acceptor.async_accept()),
+                                  { upstream },
+                                  "relay" };
+        proxy.set_bind_handler(
+            [](std::string_view system_id, std::string_view password)
+            {
+                return password == "secret" ? smpp::command_status::rok
+                                            : smpp::command_status::rinvpaswd;
+            });
+        proxy.set_route_handler(
+            [](smpp::command_id command_id, std::span<const uint8_t> body)
+            {
+                return smpp::peek_dest_addr(command_id, body) == "0000" ? 1 : 0;
+            });
+
+        auto [ec] =
+            co_await proxy.async_run(asio::as_tuple(asio::use_awaitable));
+        BOOST_CHECK(ec == smpp::error::unbinded);
+        BOOST_CHECK_EQUAL(proxy.outstanding_requests(), 0);
+
+        executed++;
+    };
+
+    auto esme = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2776 });
+        auto session = smpp::session{ std::move(socket) };
+
+        co_await session.async_send(
+            smpp::bind_transceiver{ .system_id = "esme",
+                                    .password  = "secret" });
+        auto [bind_resp, bind_seq_num, bind_status] =
+            co_await session.async_receive();
+        BOOST_CHECK(
+            std::get<smpp::bind_transceiver_resp>(bind_resp).system_id ==
+            "relay");
+        BOOST_CHECK(bind_status == smpp::command_status::rok);
+
+        // an unroutable request is rejected with its response PDU
+        co_await session.async_send(smpp::submit_sm{ .dest_addr = "0000" });
+        auto [rejected, rejected_seq_num, rejected_status] =
+            co_await session.async_receive();
+        BOOST_CHECK(std::holds_alternative<smpp::submit_sm_resp>(rejected));
+        BOOST_CHECK(rejected_status == smpp::command_status::rinvdstadr);
+
+        const auto seq_num =
+            co_await session.async_send(smpp::submit_sm{ .dest_addr = "1234" });
+        auto [resp, resp_seq_num, status] = co_await session.async_receive();
+        BOOST_CHECK(
+            std::get<smpp::submit_sm_resp>(resp) ==
+            smpp::submit_sm_resp{ .message_id = "1" });
+        BOOST_CHECK_EQUAL(resp_seq_num, seq_num);
+
+        auto [deliver, deliver_seq_num, deliver_status] =
+            co_await session.async_receive();
+        BOOST_CHECK(std::get<smpp::deliver_sm>(deliver).dest_addr == "5");
+        co_await session.async_send(
+            smpp::deliver_sm_resp{},
+            deliver_seq_num,
+            smpp::command_status::rok);
+
+        co_await session.async_send_unbind();
+        auto [ec, pdu, _, __] = co_await session.async_receive(
+            asio::as_tuple(asio::use_awaitable));
+        BOOST_CHECK(ec == smpp::error::unbinded);
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, smsc(), asio::detached);
+    asio::co_spawn(ctx, relay(), asio::detached);
+    asio::co_spawn(ctx, esme(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,203 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace asio = boost::asio;
+using namespace asio::experimental::awaitable_operators;
+
+BOOST_AUTO_TEST_SUITE(retry_scheduler)
+
+BOOST_AUTO_TEST_CASE(backoff)
+{
+    using std::chrono::milliseconds;
+
+    auto policy = smpp::retry_policy{ .max_attempts    = 5,
+                                      .initial_backoff = milliseconds{ 100 },
+                                      .max_backoff     = milliseconds{ 1000 },
+                                      .multiplier      = 2.0,
+                                      .jitter          = 0.0 };
+
+    BOOST_CHECK(policy.backoff(1, 0.5) == milliseconds{ 100 });
+    BOOST_CHECK(policy.backoff(2, 0.5) == milliseconds{ 200 });
+    BOOST_CHECK(policy.backoff(4, 0.5) == milliseconds{ 800 });
+    BOOST_CHECK(policy.backoff(5, 0.5) == milliseconds{ 1000 }); // capped
+
+    policy.jitter = 0.5;
+    BOOST_CHECK(policy.backoff(2, 0.0) == milliseconds{ 100 });
+    BOOST_CHECK(policy.backoff(2, 0.5) == milliseconds{ 150 });
+    BOOST_CHECK(policy.backoff(5, 0.0) == milliseconds{ 500 });
+}
+
+BOOST_AUTO_TEST_CASE(retry_transient_status)
+{
+    auto executed = 0;
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session   = smpp::session{ std::move(socket) };
+        auto scheduler = smpp::retry_scheduler{ session };
+        scheduler.set_policy(
+            smpp::command_status::rthrottled,
+            { .max_attempts    = 3,
+              .initial_backoff = std::chrono::milliseconds{ 50 } });
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            try
+            {
+                co_await session.async_receive();
+            }
+            catch(boost::system::system_error& e)
+            {
+                BOOST_CHECK(e.code() == asio::error::eof);
+            }
+        };
+
+        auto request = [&]() -> asio::awaitable<void>
+        {
+            auto submit_sm     = smpp::submit_sm{ .dest_addr = "1234" };
+            auto [pdu, status] = co_await scheduler.async_request(submit_sm);
+            BOOST_CHECK(
+                std::get<smpp::submit_sm_resp>(pdu) ==
+                smpp::submit_sm_resp{ .message_id = "3" });
+            BOOST_CHECK(status == smpp::command_status::rok);
+        };
+
+        co_await (
+            (receive() && request()) ||
+            scheduler.async_run(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        for(auto i = 1; i <= 3; i++)
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(std::get<smpp::submit_sm>(pdu).dest_addr == "1234");
+            BOOST_CHECK_EQUAL(seq_num, i);
+            co_await session.async_send(
+                smpp::submit_sm_resp{ .message_id = std::to_string(i) },
+                seq_num,
+                i == 3 ? smpp::command_status::rok
+                       : smpp::command_status::rthrottled);
+        }
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(retry_response_timeout)
+{
+    auto executed = 0;
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session   = smpp::session{ std::move(socket) };
+        auto scheduler = smpp::retry_scheduler{
+            session, std::chrono::milliseconds{ 100 }
+        };
+        scheduler.set_timeout_policy(
+            smpp::retry_policy{ .max_attempts    = 2,
+                                .initial_backoff = std::chrono::milliseconds{
+                                    50 } });
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            try
+            {
+                co_await session.async_receive();
+            }
+            catch(boost::system::system_error& e)
+            {
+                BOOST_CHECK(e.code() == asio::error::eof);
+            }
+        };
+
+        auto request = [&]() -> asio::awaitable<void>
+        {
+            auto submit_sm = smpp::submit_sm{ .dest_addr = "1234" };
+
+            // the first attempt times out and the second one is answered
+            auto [pdu, status] = co_await scheduler.async_request(submit_sm);
+            BOOST_CHECK(
+                std::get<smpp::submit_sm_resp>(pdu) ==
+                smpp::submit_sm_resp{ .message_id = "2" });
+            BOOST_CHECK(status == smpp::command_status::rok);
+
+            // both attempts time out
+            auto [ec, _, __] = co_await scheduler.async_request(
+                submit_sm, asio::as_tuple(asio::use_awaitable));
+            BOOST_CHECK(ec == smpp::error::response_timeout);
+        };
+
+        co_await (
+            (receive() && request()) ||
+            scheduler.async_run(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        // only the second request is answered, the frames of the retries
+        // arrive intact
+        for(auto i = 1; i <= 4; i++)
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(std::get<smpp::submit_sm>(pdu).dest_addr == "1234");
+            BOOST_CHECK_EQUAL(seq_num, i);
+            if(i == 2)
+                co_await session.async_send(
+                    smpp::submit_sm_resp{ .message_id = "2" },
+                    seq_num,
+                    smpp::command_status::rok);
+        }
+
+        auto timer = asio::steady_timer{ executor, std::chrono::seconds{ 1 } };
+        co_await timer.async_wait();
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
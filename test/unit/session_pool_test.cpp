@@ -0,0 +1,230 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace asio = boost::asio;
+using namespace asio::experimental::awaitable_operators;
+
+BOOST_AUTO_TEST_SUITE(session_pool)
+
+BOOST_AUTO_TEST_CASE(least_outstanding)
+{
+    auto executed = 0;
+
+    auto handle_session = [&](smpp::session session,
+                              int index) -> asio::awaitable<void>
+    {
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        BOOST_CHECK(
+            std::get<smpp::bind_transmitter>(pdu).system_id == "pool");
+        co_await session.async_send(
+            smpp::bind_transmitter_resp{}, seq_num, smpp::command_status::rok);
+
+        for(;;)
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(std::holds_alternative<smpp::submit_sm>(pdu));
+            co_await session.async_send(
+                smpp::submit_sm_resp{ .message_id = std::to_string(index) },
+                seq_num,
+                smpp::command_status::rok);
+        }
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+
+        for(auto i = 0; i < 2; i++)
+            asio::co_spawn(
+                executor,
+                handle_session(
+                    smpp::session{ co_await acceptor.async_accept() }, i),
+                asio::detached);
+
+        executed++;
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto pool     = smpp::session_pool{ executor,
+                                        { asio::ip::tcp::v4(), 2775 },
+                                        smpp::bind_transmitter{
+                                                .system_id = "pool" },
+                                        2 };
+
+        auto request = [&]() -> asio::awaitable<std::string>
+        {
+            auto [pdu, status] =
+                co_await pool.async_request(smpp::submit_sm{});
+            BOOST_CHECK(status == smpp::command_status::rok);
+            co_return std::get<smpp::submit_sm_resp>(pdu).message_id;
+        };
+
+        auto requests = [&]() -> asio::awaitable<void>
+        {
+            auto timer = asio::steady_timer{ executor };
+            while(pool.bound_sessions() != 2)
+            {
+                timer.expires_after(std::chrono::milliseconds{ 10 });
+                co_await timer.async_wait();
+            }
+
+            auto [id_1, id_2] = co_await (request() && request());
+            BOOST_CHECK_NE(id_1, id_2);
+            BOOST_CHECK_EQUAL(pool.outstanding_requests(), 0);
+        };
+
+        co_await (requests() || pool.async_run(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(replay_skips_serialization_failure)
+{
+    auto executed = 0;
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        co_await session.async_send(
+            smpp::bind_transmitter_resp{}, seq_num, smpp::command_status::rok);
+
+        std::tie(pdu, seq_num, status) = co_await session.async_receive();
+        BOOST_CHECK(std::get<smpp::submit_sm>(pdu).dest_addr == "1234");
+        co_await session.async_send(
+            smpp::submit_sm_resp{ .message_id = "1" },
+            seq_num,
+            smpp::command_status::rok);
+
+        executed++;
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto pool     = smpp::session_pool{ executor,
+                                        { asio::ip::tcp::v4(), 2775 },
+                                        smpp::bind_transmitter{
+                                                .system_id = "pool" },
+                                        1 };
+        pool.set_replay_on_failure(true);
+
+        auto requests = [&]() -> asio::awaitable<void>
+        {
+            auto oversize = smpp::submit_sm{ .short_message =
+                                                 std::string(255, 'a') };
+            auto [ec, pdu, status] = co_await pool.async_request(
+                oversize, asio::as_tuple(asio::use_awaitable));
+            BOOST_CHECK(ec == smpp::error::serialization_failed);
+
+            // the session stays bound
+            BOOST_CHECK_EQUAL(pool.bound_sessions(), 1);
+            auto [resp, resp_status] = co_await pool.async_request(
+                smpp::submit_sm{ .dest_addr = "1234" });
+            BOOST_CHECK(
+                std::get<smpp::submit_sm_resp>(resp).message_id == "1");
+        };
+
+        co_await (requests() || pool.async_run(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(reject_inbound_without_handler)
+{
+    auto executed = 0;
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        co_await session.async_send(
+            smpp::bind_transceiver_resp{}, seq_num, smpp::command_status::rok);
+
+        // alert_notification has no response and is dropped
+        co_await session.async_send(smpp::alert_notification{});
+
+        co_await session.async_send(smpp::deliver_sm{});
+        std::tie(pdu, seq_num, status) = co_await session.async_receive();
+        BOOST_CHECK(std::holds_alternative<smpp::deliver_sm_resp>(pdu));
+        BOOST_CHECK(status == smpp::command_status::rx_t_appn);
+
+        co_await session.async_send(smpp::data_sm{});
+        std::tie(pdu, seq_num, status) = co_await session.async_receive();
+        BOOST_CHECK(std::holds_alternative<smpp::data_sm_resp>(pdu));
+        BOOST_CHECK(status == smpp::command_status::rx_t_appn);
+
+        executed++;
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto pool     = smpp::session_pool{ executor,
+                                        { asio::ip::tcp::v4(), 2775 },
+                                        smpp::bind_transceiver{
+                                                .system_id = "pool" },
+                                        1 };
+
+        auto wait_server = [&]() -> asio::awaitable<void>
+        {
+            auto timer = asio::steady_timer{ executor };
+            while(executed == 0)
+            {
+                timer.expires_after(std::chrono::milliseconds{ 10 });
+                co_await timer.async_wait();
+            }
+        };
+
+        co_await (wait_server() || pool.async_run(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,9 +5,11 @@
 #include <smpp.hpp>
 
 #include <boost/asio.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
 #include <boost/test/unit_test.hpp>
 
 namespace asio = boost::asio;
+using namespace asio::experimental::awaitable_operators;
 
 BOOST_AUTO_TEST_SUITE(session)
 
@@ -206,4 +208,527 @@ BOOST_AUTO_TEST_CASE(enquire_link_timeout)
     BOOST_CHECK_EQUAL(executed, 2);
 }
 
+BOOST_AUTO_TEST_CASE(async_request)
+{
+    auto executed = 0;
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            // the submit_sm_resp is consumed by async_request
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(std::get<smpp::deliver_sm>(pdu) == smpp::deliver_sm{});
+            co_await session.async_send(
+                smpp::deliver_sm_resp{}, seq_num, smpp::command_status::rok);
+
+            try
+            {
+                co_await session.async_receive();
+            }
+            catch(boost::system::system_error& e)
+            {
+                BOOST_CHECK(e.code() == asio::error::eof);
+            }
+        };
+
+        auto request = [&]() -> asio::awaitable<void>
+        {
+            auto [pdu, status] =
+                co_await session.async_request(smpp::submit_sm{});
+            BOOST_CHECK(
+                std::get<smpp::submit_sm_resp>(pdu) ==
+                smpp::submit_sm_resp{ .message_id = "1" });
+            BOOST_CHECK(status == smpp::command_status::rthrottled);
+        };
+
+        co_await (receive() && request());
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        BOOST_CHECK(std::get<smpp::submit_sm>(pdu) == smpp::submit_sm{});
+
+        co_await session.async_send(smpp::deliver_sm{});
+        co_await session.async_receive();
+
+        co_await session.async_send(
+            smpp::submit_sm_resp{ .message_id = "1" },
+            seq_num,
+            smpp::command_status::rthrottled);
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_request_receive_cancelled)
+{
+    auto executed = 0;
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            auto [ec, pdu, seq_num, status] = co_await session.async_receive(
+                asio::cancel_after(
+                    std::chrono::milliseconds{ 100 },
+                    asio::as_tuple(asio::use_awaitable)));
+            BOOST_CHECK(ec == asio::error::operation_aborted);
+        };
+
+        // the pending request fails instead of waiting forever
+        auto request = [&]() -> asio::awaitable<void>
+        {
+            auto [ec, pdu, status] = co_await session.async_request(
+                smpp::submit_sm{}, asio::as_tuple(asio::use_awaitable));
+            BOOST_CHECK(ec == asio::error::operation_aborted);
+        };
+
+        co_await (receive() && request());
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        BOOST_CHECK(std::holds_alternative<smpp::submit_sm>(pdu));
+
+        auto timer = asio::steady_timer{ executor, std::chrono::seconds{ 1 } };
+        co_await timer.async_wait();
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_send_pdu_template)
+{
+    auto executed = 0;
+
+    const auto prototype = smpp::submit_sm{
+        .source_addr     = "CAMPAIGN",
+        .validity_period = "000001000000000R",
+        .data_coding     = smpp::data_coding::ucs2,
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        const auto pdu_template = smpp::pdu_template{ prototype };
+        for(auto dest_addr : { "1111", "22222222" })
+            co_await session.async_send(pdu_template, dest_addr, "body");
+
+        auto [ec, _] = co_await session.async_send(
+            pdu_template,
+            "a dest_addr longer than its limit",
+            "",
+            asio::as_tuple(asio::use_awaitable));
+        BOOST_CHECK(ec == smpp::error::serialization_failed);
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto expected          = prototype;
+        expected.short_message = "body";
+        for(auto [dest_addr, seq] : { std::pair{ "1111", 1u },
+                                      std::pair{ "22222222", 2u } })
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            expected.dest_addr          = dest_addr;
+            BOOST_CHECK(std::get<smpp::submit_sm>(pdu) == expected);
+            BOOST_CHECK_EQUAL(seq_num, seq);
+        }
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_send_shared_frame)
+{
+    auto executed = 0;
+
+    const auto alert = smpp::alert_notification{
+        .source_addr = "1234",
+        .esme_addr   = "5678",
+    };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        const auto frame = smpp::shared_frame{ alert };
+        for(auto i = 0; i < 3; i++)
+            co_await session.async_send(frame);
+        BOOST_CHECK_EQUAL(frame.use_count(), 1);
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        for(auto seq = 1u; seq <= 3; seq++)
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(std::get<smpp::alert_notification>(pdu) == alert);
+            BOOST_CHECK_EQUAL(seq_num, seq);
+        }
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_send_range)
+{
+    auto executed = 0;
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            // all the responses are consumed by async_send_range
+            try
+            {
+                co_await session.async_receive();
+            }
+            catch(boost::system::system_error& e)
+            {
+                BOOST_CHECK(e.code() == asio::error::eof);
+            }
+        };
+
+        auto send_range = [&]() -> asio::awaitable<void>
+        {
+            auto pdus = std::vector<smpp::submit_sm>(5);
+            pdus[2].service_type = "exceeds its limit";
+
+            auto responses = std::vector<std::string>(pdus.size());
+            auto sent      = co_await session.async_send_range(
+                pdus,
+                2,
+                std::chrono::seconds{ 5 },
+                [&](std::size_t index,
+                    boost::system::error_code ec,
+                    smpp::pdu_variant pdu,
+                    smpp::command_status)
+                {
+                    if(ec == smpp::error::serialization_failed)
+                        responses.at(index) = "serialization_failed";
+                    else
+                        responses.at(index) =
+                            std::get<smpp::submit_sm_resp>(pdu).message_id;
+                });
+
+            BOOST_CHECK_EQUAL(sent, 4);
+            BOOST_CHECK(responses[0] == "1");
+            BOOST_CHECK(responses[1] == "2");
+            BOOST_CHECK(responses[2] == "serialization_failed");
+            BOOST_CHECK(responses[3] == "3");
+            BOOST_CHECK(responses[4] == "4");
+        };
+
+        co_await (receive() && send_range());
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        for(auto i = 0; i < 4; i++)
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            BOOST_CHECK(std::get<smpp::submit_sm>(pdu) == smpp::submit_sm{});
+            co_await session.async_send(
+                smpp::submit_sm_resp{ .message_id = std::to_string(seq_num) },
+                seq_num,
+                smpp::command_status::rok);
+        }
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_send_range_timeout)
+{
+    auto executed = 0;
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        auto receive = [&]() -> asio::awaitable<void>
+        {
+            co_await session.async_receive();
+        };
+
+        auto send_range = [&]() -> asio::awaitable<void>
+        {
+            auto pdus      = std::vector<smpp::submit_sm>(3);
+            auto responses = std::vector<std::string>(pdus.size());
+            auto sent      = co_await session.async_send_range(
+                pdus,
+                2,
+                std::chrono::milliseconds{ 200 },
+                [&](std::size_t index,
+                    boost::system::error_code ec,
+                    smpp::pdu_variant pdu,
+                    smpp::command_status)
+                {
+                    if(ec == smpp::error::response_timeout)
+                        responses.at(index) = "response_timeout";
+                    else
+                        responses.at(index) =
+                            std::get<smpp::submit_sm_resp>(pdu).message_id;
+                });
+
+            // the lost response doesn't hold back the others
+            BOOST_CHECK_EQUAL(sent, 3);
+            BOOST_CHECK(responses[0] == "response_timeout");
+            BOOST_CHECK(responses[1] == "2");
+            BOOST_CHECK(responses[2] == "3");
+        };
+
+        co_await (receive() || send_range());
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        for(auto i = 0; i < 3; i++)
+        {
+            auto [pdu, seq_num, status] = co_await session.async_receive();
+            if(seq_num == 1)
+                continue;
+            co_await session.async_send(
+                smpp::submit_sm_resp{ .message_id = std::to_string(seq_num) },
+                seq_num,
+                smpp::command_status::rok);
+        }
+
+        // until the client closes the session
+        co_await session.async_receive(asio::as_tuple(asio::use_awaitable));
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_send_message_payload)
+{
+    auto executed = 0;
+
+    const auto payload = std::string(60000, 'x');
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        co_await session.async_send(
+            smpp::data_sm{ .dest_addr = "1234" }, asio::buffer(payload));
+
+        auto [ec, _] = co_await session.async_send(
+            smpp::data_sm{},
+            asio::buffer(std::string(70000, 'x')),
+            asio::as_tuple(asio::use_awaitable));
+        BOOST_CHECK(ec == smpp::error::serialization_failed);
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [pdu, seq_num, status] = co_await session.async_receive();
+        const auto& data_sm         = std::get<smpp::data_sm>(pdu);
+        BOOST_CHECK_EQUAL(data_sm.dest_addr, "1234");
+        BOOST_CHECK(
+            data_sm.oparam.get_as_string(
+                smpp::oparam_tag::message_payload) == payload);
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_receive_and_send_raw)
+{
+    auto executed = 0;
+
+    const auto submit_sm = smpp::submit_sm{ .dest_addr = "1234" };
+
+    auto client = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto socket   = asio::ip::tcp::socket{ executor };
+        co_await socket.async_connect({ asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ std::move(socket) };
+
+        auto body = std::vector<uint8_t>{};
+        smpp::serialize_to(&body, submit_sm);
+        auto seq_num = co_await session.async_send_raw(
+            smpp::command_id::submit_sm, asio::buffer(body));
+        BOOST_CHECK_EQUAL(seq_num, 1u);
+
+        auto [pdu, resp_seq_num, status] = co_await session.async_receive();
+        BOOST_CHECK(
+            std::get<smpp::submit_sm_resp>(pdu) ==
+            smpp::submit_sm_resp{ .message_id = "12" });
+        BOOST_CHECK_EQUAL(resp_seq_num, seq_num);
+        BOOST_CHECK(status == smpp::command_status::rthrottled);
+
+        executed++;
+    };
+
+    auto server = [&]() -> asio::awaitable<void>
+    {
+        auto executor = co_await asio::this_coro::executor;
+        auto acceptor =
+            asio::ip::tcp::acceptor(executor, { asio::ip::tcp::v4(), 2775 });
+        auto session = smpp::session{ co_await acceptor.async_accept() };
+
+        auto [command_id, body, seq_num, status] =
+            co_await session.async_receive_raw();
+        BOOST_CHECK(command_id == smpp::command_id::submit_sm);
+        BOOST_CHECK(smpp::deserialize<smpp::submit_sm>(body) == submit_sm);
+
+        const auto resp_body = std::string_view{ "12", 3 };
+        co_await session.async_send_raw(
+            smpp::command_id::submit_sm_resp,
+            asio::buffer(resp_body),
+            seq_num,
+            smpp::command_status::rthrottled);
+
+        executed++;
+    };
+
+    auto ctx = asio::io_context{};
+
+    asio::co_spawn(ctx, server(), asio::detached);
+    asio::co_spawn(ctx, client(), asio::detached);
+
+    ctx.run_for(std::chrono::seconds{ 3 });
+    BOOST_CHECK_EQUAL(executed, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
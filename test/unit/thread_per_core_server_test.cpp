@@ -0,0 +1,71 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+
+namespace asio = boost::asio;
+
+BOOST_AUTO_TEST_SUITE(thread_per_core_server)
+
+BOOST_AUTO_TEST_CASE(accept_and_post)
+{
+    auto server =
+        smpp::thread_per_core_server{ { asio::ip::tcp::v4(), 2775 }, 2 };
+    auto accepted = std::atomic<int>{};
+
+    auto handler = [&](asio::ip::tcp::socket, std::size_t)
+    {
+        // hands the work over to core 0
+        server.post(
+            0,
+            [&]
+            {
+                accepted++;
+                server.stop();
+            });
+    };
+
+    auto thread = std::thread{ [&] { server.run(handler); } };
+
+    auto ctx    = asio::io_context{};
+    auto socket = asio::ip::tcp::socket{ ctx };
+    for(auto i = 0; i < 100; i++)
+    {
+        auto ec = boost::system::error_code{};
+        socket.connect({ asio::ip::make_address("127.0.0.1"), 2775 }, ec);
+        if(!ec)
+            break;
+        socket.close();
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+    }
+
+    thread.join();
+    BOOST_CHECK_EQUAL(accepted, 1);
+}
+
+BOOST_AUTO_TEST_CASE(reuse_port)
+{
+    auto ctx    = asio::io_context{};
+    auto first  = asio::ip::tcp::acceptor{ ctx, asio::ip::tcp::v4() };
+    auto second = asio::ip::tcp::acceptor{ ctx, asio::ip::tcp::v4() };
+
+    first.set_option(smpp::reuse_port{ true });
+    auto option = smpp::reuse_port{};
+    first.get_option(option);
+    BOOST_CHECK(option.value());
+
+    // a second acceptor can listen on the same endpoint
+    first.bind({ asio::ip::make_address("127.0.0.1"), 0 });
+    first.listen();
+    second.set_option(smpp::reuse_port{ true });
+    second.bind(first.local_endpoint());
+    second.listen();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,627 @@
+// Copyright (c) 2022 Mohammad Nejati
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <smpp/pdu/deliver_sm.hpp>
+#include <smpp/utility.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(utility)
+
+BOOST_AUTO_TEST_CASE(gsm_septet)
+{
+    using namespace std::string_literals;
+
+    BOOST_CHECK_EQUAL(smpp::udh_fill_bits(6), 1);
+    BOOST_CHECK_EQUAL(smpp::udh_fill_bits(7), 0);
+    BOOST_CHECK_EQUAL(smpp::packed_septets_size(160), 140);
+    BOOST_CHECK_EQUAL(smpp::packed_septets_size(153, 1), 134);
+
+    BOOST_CHECK(
+        smpp::pack_septets("hellohello") ==
+        "\xE8\x32\x9B\xFD\x46\x97\xD9\xEC\x37"s);
+    BOOST_CHECK(
+        smpp::unpack_septets("\xE8\x32\x9B\xFD\x46\x97\xD9\xEC\x37", 10) ==
+        "hellohello");
+
+    // compare with a bit by bit reference for all lengths and fill bits
+    auto reference = [](std::string_view septets, uint8_t fill_bits)
+    {
+        const auto size = smpp::packed_septets_size(septets.size(), fill_bits);
+        auto packed     = std::string(size, '\0');
+        auto bit = std::size_t{ fill_bits };
+        for(auto s : septets)
+            for(auto i = 0; i < 7; i++, bit++)
+                if(s & (1 << i))
+                    packed[bit / 8] |= static_cast<char>(1 << (bit % 8));
+        return packed;
+    };
+
+    auto septets = std::string{};
+    for(auto i = 0; i < 300; i++)
+    {
+        for(uint8_t fill_bits = 0; fill_bits < 7; fill_bits++)
+        {
+            const auto packed = smpp::pack_septets(septets, fill_bits);
+            BOOST_CHECK(packed == reference(septets, fill_bits));
+            BOOST_CHECK(
+                smpp::unpack_septets(packed, septets.size(), fill_bits) ==
+                septets);
+        }
+        septets.push_back(static_cast<char>((i * 37 + 11) % 128));
+    }
+
+    BOOST_CHECK_THROW(smpp::unpack_septets("\x01", 2), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(utf8_ucs2)
+{
+    using namespace std::string_literals;
+
+    const auto utf8 = "Hello, this is ASCII text! "
+                      "\xD8\xB3\xD9\x84\xD8\xA7\xD9\x85 \xE2\x82\xAC "
+                      "\xF0\x9F\x98\x80"s;
+    const auto ucs2 =
+        "\0H\0e\0l\0l\0o\0,\0 \0t\0h\0i\0s\0 \0i\0s\0 \0A\0S\0C\0I\0I"
+        "\0 \0t\0e\0x\0t\0!\0 "
+        "\x06\x33\x06\x44\x06\x27\x06\x45\0 \x20\xAC\0 "
+        "\xD8\x3D\xDE\x00"s;
+
+    BOOST_CHECK(smpp::convert_utf8_to_ucs2(utf8) == ucs2);
+    BOOST_CHECK(smpp::convert_ucs2_to_utf8(ucs2) == utf8);
+
+    auto buf = std::array<char, 64>{};
+    BOOST_CHECK_EQUAL(smpp::convert_utf8_to_ucs2("ab", buf.data()), 4);
+    BOOST_CHECK_EQUAL(smpp::convert_ucs2_to_utf8("\0a\0b"s, buf.data()), 2);
+
+    // overlong, encoded surrogate, truncated
+    BOOST_CHECK_THROW(
+        smpp::convert_utf8_to_ucs2("\xC0\xAF"), std::invalid_argument);
+    BOOST_CHECK_THROW(
+        smpp::convert_utf8_to_ucs2("\xED\xA0\x80"), std::invalid_argument);
+    BOOST_CHECK_THROW(
+        smpp::convert_utf8_to_ucs2("\xE2\x82"), std::invalid_argument);
+
+    BOOST_CHECK_THROW(
+        smpp::convert_ucs2_to_utf8("\xDC\x00"s), std::invalid_argument);
+    BOOST_CHECK_THROW(smpp::convert_ucs2_to_utf8("\0"s), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(encoding_planner)
+{
+    using smpp::data_coding;
+    using smpp::encoding_plan;
+
+    BOOST_CHECK(
+        smpp::plan_encoding(std::string(160, 'a')) ==
+        (encoding_plan{ data_coding::defaults, 160, 1, 1 }));
+    BOOST_CHECK(
+        smpp::plan_encoding(std::string(161, 'a')) ==
+        (encoding_plan{ data_coding::defaults, 161, 2, 2 }));
+
+    // an escaped character is not split between segments
+    const auto escaped = std::string(152, 'a') + "{" + std::string(152, 'a');
+    BOOST_CHECK(
+        smpp::plan_encoding(escaped) ==
+        (encoding_plan{ data_coding::defaults, 306, 3, 2 }));
+
+    // \u00E1 is in ISO 8859-1 but not in GSM 03.38
+    BOOST_CHECK(
+        smpp::plan_encoding("caf\xC3\xA1") ==
+        (encoding_plan{ data_coding::iso8859_1, 4, 1, 1 }));
+    BOOST_CHECK(
+        smpp::plan_encoding("caf\xC3\xA1", { .allow_latin1 = false }) ==
+        (encoding_plan{ data_coding::ucs2, 8, 1, 1 }));
+
+    // smart quotes are transliterated to ASCII quotes
+    const auto quoted = "\xE2\x80\x9Cquoted\xE2\x80\x9D";
+    BOOST_CHECK(
+        smpp::plan_encoding(quoted).data_coding == data_coding::ucs2);
+    BOOST_CHECK(
+        smpp::plan_encoding(quoted, { .transliterate = true }) ==
+        (encoding_plan{ data_coding::defaults, 8, 1, 1 }));
+    BOOST_CHECK(smpp::convert_utf8_to_gsm(quoted, true) == "\"quoted\"");
+    BOOST_CHECK_THROW(smpp::convert_utf8_to_gsm(quoted), std::invalid_argument);
+
+    // a surrogate pair is not split between segments
+    auto emoji = std::string{};
+    for(auto i = 0; i < 35; i++)
+        emoji += "\xF0\x9F\x98\x80";
+    BOOST_CHECK(
+        smpp::plan_encoding(emoji) ==
+        (encoding_plan{ data_coding::ucs2, 140, 1, 1 }));
+    BOOST_CHECK(
+        smpp::plan_encoding("a" + emoji) ==
+        (encoding_plan{ data_coding::ucs2, 142, 2, 2 }));
+
+    BOOST_CHECK(
+        smpp::convert_gsm_to_ucs2(smpp::convert_utf8_to_gsm("\xE2\x82\xAC[")) ==
+        smpp::convert_utf8_to_ucs2("\xE2\x82\xAC["));
+}
+
+BOOST_AUTO_TEST_CASE(gsm_national_language)
+{
+    using smpp::data_coding;
+    using smpp::gsm_alphabet;
+    using enum smpp::gsm_national_language;
+
+    // ğış are in the Turkish shift tables
+    const auto text = "\xC4\x9F\xC4\xB1\xC5\x9F";
+    BOOST_CHECK_THROW(
+        smpp::convert_utf8_to_gsm(text), std::invalid_argument);
+
+    const auto single = gsm_alphabet{ .single_shift = turkish };
+    BOOST_CHECK(
+        smpp::convert_utf8_to_gsm(text, false, single) ==
+        "\x1B\x67\x1B\x69\x1B\x73");
+    BOOST_CHECK(
+        smpp::convert_gsm_to_ucs2(
+            smpp::convert_utf8_to_gsm(text, false, single), single) ==
+        smpp::convert_utf8_to_ucs2(text));
+
+    const auto locking = gsm_alphabet{ .locking_shift = turkish };
+    BOOST_CHECK(
+        smpp::convert_gsm_to_ucs2(
+            smpp::convert_utf8_to_gsm(text, false, locking), locking) ==
+        smpp::convert_utf8_to_ucs2(text));
+
+    // the national language is preferred over UCS-2
+    BOOST_CHECK(
+        smpp::plan_encoding(text).data_coding == data_coding::ucs2);
+    BOOST_CHECK(
+        smpp::plan_encoding(text, { .national_language = turkish }) ==
+        (smpp::encoding_plan{ data_coding::defaults, 6, 1, 1, single }));
+
+    // a locking shift table needs fewer segments for long texts
+    auto long_text = std::string{};
+    for(auto i = 0; i < 60; i++)
+        long_text += text;
+    const auto plan =
+        smpp::plan_encoding(long_text, { .national_language = turkish });
+    BOOST_CHECK(plan.alphabet == locking);
+    BOOST_CHECK_EQUAL(plan.length, 180);
+    BOOST_CHECK_EQUAL(plan.segments, 2);
+
+    // no-break space is not the escape of the default alphabet
+    BOOST_CHECK_THROW(
+        smpp::convert_utf8_to_gsm("\xC2\xA0"), std::invalid_argument);
+
+    auto udh = smpp::user_data_header{};
+    udh.set_gsm_alphabet({ turkish, turkish });
+    BOOST_CHECK(udh.serialize() == "\x24\x01\x01\x25\x01\x01");
+    BOOST_CHECK(
+        smpp::user_data_header{ udh.serialize() }.get_gsm_alphabet() ==
+        (gsm_alphabet{ turkish, turkish }));
+    udh.set_gsm_alphabet({});
+    BOOST_CHECK(udh.get_gsm_alphabet() == gsm_alphabet{});
+}
+
+BOOST_AUTO_TEST_CASE(gsm_national_language_round_trip)
+{
+    using smpp::gsm_alphabet;
+    using enum smpp::gsm_national_language;
+    namespace detail = smpp::detail;
+
+    // ãõ replace äö of the default alphabet
+    const auto portuguese_locking = gsm_alphabet{ .locking_shift = portuguese };
+    BOOST_CHECK(
+        smpp::convert_gsm_to_ucs2("\x7B\x7C", portuguese_locking) ==
+        smpp::convert_utf8_to_ucs2("\xC3\xA3\xC3\xB5"));
+    BOOST_CHECK(
+        smpp::convert_utf8_to_gsm(
+            "\xC3\xA3\xC3\xB5", false, portuguese_locking) == "\x7B\x7C");
+
+    // every character that a table defines differently round trips
+    auto round_trip = [](const detail::gsm_table& table,
+                         const detail::gsm_table& base,
+                         bool single_shift,
+                         gsm_alphabet alphabet)
+    {
+        auto gsm = std::string{};
+        for(auto i = 0; i < 128; i++)
+        {
+            if(table[i] == 0 || table[i] == base[i] || i == detail::gsm_escape)
+                continue;
+            if(single_shift)
+                gsm += static_cast<char>(detail::gsm_escape);
+            gsm += static_cast<char>(i);
+        }
+        BOOST_REQUIRE(!gsm.empty());
+
+        const auto ucs2 = smpp::convert_gsm_to_ucs2(gsm, alphabet);
+        const auto utf8 = smpp::convert_ucs2_to_utf8(ucs2);
+        BOOST_CHECK(
+            smpp::convert_gsm_to_ucs2(
+                smpp::convert_utf8_to_gsm(utf8, false, alphabet), alphabet) ==
+            ucs2);
+    };
+
+    round_trip(
+        detail::gsm_turkish_locking_shift,
+        detail::gsm_default_alphabet,
+        false,
+        { .locking_shift = turkish });
+    round_trip(
+        detail::gsm_portuguese_locking_shift,
+        detail::gsm_default_alphabet,
+        false,
+        portuguese_locking);
+    round_trip(
+        detail::gsm_turkish_single_shift,
+        detail::gsm_default_extension,
+        true,
+        { .single_shift = turkish });
+    round_trip(
+        detail::gsm_spanish_single_shift,
+        detail::gsm_default_extension,
+        true,
+        { .single_shift = spanish });
+    round_trip(
+        detail::gsm_portuguese_single_shift,
+        detail::gsm_default_extension,
+        true,
+        { .single_shift = portuguese });
+}
+
+BOOST_AUTO_TEST_CASE(message_segmenter)
+{
+    using smpp::concatenation;
+    using smpp::data_coding;
+    using smpp::gsm_network_features;
+    using smpp::oparam_tag;
+
+    auto prototype      = smpp::submit_sm{};
+    prototype.dest_addr = "989123456789";
+    auto parts          = std::vector<smpp::submit_sm>{};
+
+    auto segmenter = smpp::message_segmenter{};
+    BOOST_CHECK_EQUAL(segmenter.segment(prototype, "hello", parts), 1);
+    BOOST_CHECK(parts[0].short_message == "hello");
+    BOOST_CHECK(
+        parts[0].esm_class.gsm_network_features == gsm_network_features::no);
+
+    // an escaped character is not split between segments
+    const auto text = std::string(152, 'a') + "{" + std::string(152, 'a');
+    BOOST_CHECK_EQUAL(segmenter.segment(prototype, text, parts), 3);
+    const auto ref = parts[0].short_message[3];
+    const auto udh = std::string{ '\x05', '\x00', '\x03', ref, '\x03', '\x01' };
+    BOOST_CHECK(parts[0].short_message == udh + std::string(152, 'a'));
+    BOOST_CHECK(parts[1].short_message.substr(6, 2) == "\x1B\x28");
+    BOOST_CHECK(
+        parts[2].esm_class.gsm_network_features == gsm_network_features::uhdi);
+    BOOST_CHECK(parts[2].data_coding == data_coding::defaults);
+
+    // consecutive messages to a destination get consecutive references
+    segmenter.segment(prototype, text, parts);
+    BOOST_CHECK_EQUAL(parts[0].short_message[3], ref + 1);
+
+    // a surrogate pair is not split between segments
+    auto emoji = std::string{ "a" };
+    for(auto i = 0; i < 35; i++)
+        emoji += "\xF0\x9F\x98\x80";
+    segmenter = smpp::message_segmenter{ { concatenation::udh_16bit } };
+    BOOST_CHECK_EQUAL(segmenter.segment(prototype, emoji, parts), 2);
+    BOOST_CHECK(parts[0].data_coding == data_coding::ucs2);
+    BOOST_CHECK_EQUAL(parts[0].short_message.size(), 7 + 130);
+    BOOST_CHECK_EQUAL(parts[1].short_message.size(), 7 + 12);
+
+    segmenter = smpp::message_segmenter{ { concatenation::sar } };
+    BOOST_CHECK_EQUAL(
+        segmenter.segment(prototype, std::string(161, 'a'), parts), 2);
+    BOOST_CHECK(parts[0].short_message == std::string(160, 'a'));
+    BOOST_CHECK(
+        parts[1].oparam.get_as_string(oparam_tag::sar_total_segments) ==
+        "\x02");
+    BOOST_CHECK(
+        parts[1].oparam.get_as_string(oparam_tag::sar_segment_seqnum) ==
+        "\x02");
+
+    // the optional parameters of the prototype are in every part
+    prototype.oparam.set_as_string(oparam_tag::user_message_reference, "ab");
+    BOOST_CHECK_EQUAL(
+        segmenter.segment(prototype, std::string(321, 'a'), parts), 3);
+    for(auto i = 0; i < 3; i++)
+    {
+        BOOST_CHECK(parts[i].short_message.size() == (i < 2 ? 160 : 1));
+        BOOST_CHECK(
+            parts[i].oparam.get_as_string(oparam_tag::sar_segment_seqnum) ==
+            std::string(1, static_cast<char>(i + 1)));
+        BOOST_CHECK(
+            parts[i].oparam.get_as_string(oparam_tag::user_message_reference) ==
+            "ab");
+    }
+    prototype.oparam.erase(oparam_tag::user_message_reference);
+
+    auto data_parts = std::vector<smpp::data_sm>{};
+    segmenter = smpp::message_segmenter{ { concatenation::message_payload } };
+    BOOST_CHECK_EQUAL(
+        segmenter.segment(smpp::data_sm{}, std::string(300, 'a'), data_parts),
+        1);
+    BOOST_CHECK(
+        data_parts[0].oparam.get_as_string(oparam_tag::message_payload) ==
+        std::string(300, 'a'));
+}
+
+BOOST_AUTO_TEST_CASE(message_reassembler)
+{
+    using smpp::concatenation;
+    using namespace std::chrono_literals;
+
+    auto completed   = std::vector<std::string>{};
+    auto reassembler = smpp::message_reassembler<smpp::submit_sm>{
+        [&](const smpp::submit_sm&, std::string_view body)
+        { completed.emplace_back(body); },
+        { .timeout = 10s, .max_messages = 2 }
+    };
+
+    auto prototype        = smpp::submit_sm{};
+    prototype.source_addr = "1234";
+    prototype.dest_addr   = "989123456789";
+    auto parts            = std::vector<smpp::submit_sm>{};
+    const auto text       = std::string(400, 'a') + "{}";
+    const auto now        = std::chrono::steady_clock::time_point{};
+
+    // out of order and duplicate parts
+    auto segmenter = smpp::message_segmenter{};
+    BOOST_CHECK_EQUAL(segmenter.segment(prototype, text, parts), 3);
+    BOOST_CHECK(!reassembler.add(parts[2], now));
+    BOOST_CHECK(!reassembler.add(parts[2], now));
+    BOOST_CHECK(!reassembler.add(parts[0], now));
+    BOOST_CHECK_EQUAL(reassembler.pending(), 1);
+    BOOST_CHECK(reassembler.add(parts[1], now));
+    BOOST_CHECK_EQUAL(completed.size(), 1);
+    BOOST_CHECK(completed[0] == smpp::convert_utf8_to_gsm(text));
+    BOOST_CHECK_EQUAL(reassembler.pending(), 0);
+    BOOST_CHECK_EQUAL(reassembler.pending_bytes(), 0);
+
+    segmenter = smpp::message_segmenter{ { concatenation::sar } };
+    segmenter.segment(prototype, text, parts);
+    for(const auto& part : parts)
+        reassembler.add(part, now);
+    BOOST_CHECK_EQUAL(completed.size(), 2);
+    BOOST_CHECK(completed[1] == completed[0]);
+
+    // incomplete messages time out
+    reassembler.add(parts[0], now);
+    reassembler.expire(now + 10s);
+    BOOST_CHECK_EQUAL(reassembler.pending(), 0);
+    BOOST_CHECK_EQUAL(reassembler.evicted(), 1);
+
+    // the oldest message is evicted when there are too many
+    for(auto i = 0; i < 3; i++)
+    {
+        segmenter.segment(prototype, text, parts);
+        reassembler.add(parts[0], now);
+    }
+    BOOST_CHECK_EQUAL(reassembler.pending(), 2);
+    BOOST_CHECK_EQUAL(reassembler.evicted(), 2);
+
+    BOOST_CHECK(reassembler.add(prototype, now));
+    BOOST_CHECK_EQUAL(completed.size(), 3);
+
+    // the handler completes another message from within add
+    auto bodies = std::vector<std::string>{};
+    auto nested = std::vector<smpp::submit_sm>{};
+    smpp::message_reassembler<smpp::submit_sm> reentrant{
+        [&](const smpp::submit_sm& first, std::string_view body)
+        {
+            for(const auto& part : std::exchange(nested, {}))
+                reentrant.add(part, now);
+            BOOST_CHECK(first.dest_addr == prototype.dest_addr);
+            bodies.emplace_back(body);
+        }
+    };
+    segmenter = smpp::message_segmenter{};
+    segmenter.segment(prototype, std::string(200, 'b'), nested);
+    segmenter.segment(prototype, text, parts);
+    for(const auto& part : parts)
+        reentrant.add(part, now);
+    BOOST_CHECK_EQUAL(bodies.size(), 2);
+    BOOST_CHECK(bodies[0] == std::string(200, 'b'));
+    BOOST_CHECK(bodies[1] == completed[0]);
+    BOOST_CHECK_EQUAL(reentrant.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(user_data_header)
+{
+    using smpp::data_coding;
+    using smpp::gsm_network_features;
+    using namespace std::string_literals;
+
+    auto udh = smpp::user_data_header{ { .concat_sm_ref_num_ = 0x1234,
+                                         .number_of_parts_   = 3,
+                                         .sequence_number_   = 2 } };
+    udh.set_gsm_alphabet(
+        { .single_shift = smpp::gsm_national_language::turkish });
+    BOOST_CHECK(udh.view() == "\x08\x04\x12\x34\x03\x02\x24\x01\x01");
+    BOOST_CHECK_EQUAL(udh.count(), 2);
+
+    // replacing an information element keeps the others
+    udh.set_multi_part_data({ 0xF0, 3, 3 });
+    BOOST_CHECK(udh.view() == "\x24\x01\x01\x00\x03\xF0\x03\x03"s);
+    BOOST_CHECK_EQUAL(udh.get_multi_part_data().concat_sm_ref_num_, 0xF0);
+    BOOST_CHECK(!udh.find(0x08));
+    BOOST_CHECK_THROW(
+        udh.add(0x70, std::string(smpp::user_data_header::max_size, 'a')),
+        std::length_error);
+
+    // a parsed header that is one octet short of max_size
+    auto full = smpp::user_data_header{ "\x70\x88"s + std::string(136, 'a') };
+    BOOST_CHECK_EQUAL(full.view().size(), 138);
+    BOOST_CHECK_THROW(full.add(0x71, "abc"), std::length_error);
+    BOOST_CHECK_THROW(full.add(0x71, ""), std::length_error);
+    BOOST_CHECK_EQUAL(full.view().size(), 138);
+    full.erase(0x70);
+    full.add(0x71, std::string(137, 'b'));
+    BOOST_CHECK_EQUAL(full.view().size(), smpp::user_data_header::max_size);
+
+    auto buf        = std::array<char, 160>{};
+    const auto size = smpp::pack_short_message(
+        udh, "body", data_coding::defaults, buf.data());
+    const auto short_message = std::string_view{ buf.data(), size };
+    BOOST_CHECK(short_message == "\x08" + udh.serialize() + "body");
+
+    auto parsed     = smpp::user_data_header{};
+    const auto body = smpp::unpack_short_message(
+        { .gsm_network_features = gsm_network_features::uhdi },
+        data_coding::defaults,
+        short_message,
+        parsed);
+    BOOST_CHECK(body == "body");
+    BOOST_CHECK(body.data() == buf.data() + 9);
+    BOOST_CHECK(parsed == udh);
+
+    BOOST_CHECK_THROW(
+        smpp::pack_short_message(udh, std::string(140, 'a'), data_coding::ucs2),
+        std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(delivery_receipt)
+{
+    using smpp::message_state;
+    using namespace std::chrono;
+
+    const auto text = std::string_view{
+        "id:0123456789 sub:001 dlvrd:001 submit date:2301021504 "
+        "done date:230102150512 stat:DELIVRD err:000 text:Hello world"
+    };
+    const auto receipt = smpp::parse_delivery_receipt(text);
+    BOOST_REQUIRE(receipt);
+    BOOST_CHECK(receipt->id == "0123456789");
+    BOOST_CHECK_EQUAL(receipt->submitted, 1);
+    BOOST_CHECK_EQUAL(receipt->delivered, 1);
+    BOOST_CHECK(
+        receipt->submit_date ==
+        sys_days{ 2023y / January / 2 } + 15h + 4min);
+    BOOST_CHECK(
+        receipt->done_date ==
+        sys_days{ 2023y / January / 2 } + 15h + 5min + 12s);
+    BOOST_CHECK(receipt->state == message_state::delivered);
+    BOOST_CHECK(receipt->error == "000");
+    BOOST_CHECK(receipt->text == "Hello world");
+
+    // vendor variants
+    const auto variant = smpp::parse_delivery_receipt(
+        "Id:abc Submit_Date:2301021504 Stat:UNDELIVERABLE Err:5");
+    BOOST_REQUIRE(variant);
+    BOOST_CHECK(variant->id == "abc");
+    BOOST_CHECK(variant->state == message_state::undeliverable);
+    BOOST_CHECK(variant->error == "5");
+    BOOST_CHECK(!smpp::parse_delivery_receipt("hello"));
+
+    // the optional parameters are preferred
+    auto pdu          = smpp::deliver_sm{};
+    pdu.short_message = text;
+    pdu.oparam.set_as_string(
+        smpp::oparam_tag::receipted_message_id, { "ABC", 4 });
+    pdu.oparam.set_as_enum_u8(
+        smpp::oparam_tag::message_state, message_state::expired);
+    const auto from_pdu = smpp::parse_delivery_receipt(pdu);
+    BOOST_REQUIRE(from_pdu);
+    BOOST_CHECK(from_pdu->id == "ABC");
+    BOOST_CHECK(from_pdu->state == message_state::expired);
+    BOOST_CHECK(from_pdu->text == "Hello world");
+
+    auto buf            = std::array<char, smpp::max_delivery_receipt_size>{};
+    auto formatted      = *receipt;
+    formatted.done_date = floor<minutes>(formatted.done_date);
+    const auto size     = smpp::format_delivery_receipt(formatted, buf.data());
+    BOOST_CHECK(
+        std::string_view(buf.data(), size) ==
+        "id:0123456789 sub:001 dlvrd:001 submit date:2301021504 "
+        "done date:2301021505 stat:DELIVRD err:000 text:Hello world");
+    BOOST_CHECK(
+        smpp::parse_delivery_receipt({ buf.data(), size }) == formatted);
+}
+
+BOOST_AUTO_TEST_CASE(smpp_time)
+{
+    using namespace std::chrono;
+
+    constexpr auto now =
+        smpp::smpp_time_point{ sys_days{ 2023y / January / 31 } + 10h + 30min };
+
+    // 14:04:05.6 at UTC+01:00
+    static_assert(
+        smpp::parse_smpp_time("230102140405604+", now) ==
+        sys_days{ 2023y / January / 2 } + 13h + 4min + 5s + 600ms);
+    BOOST_CHECK(
+        smpp::parse_smpp_time("230102140405008-", now) ==
+        sys_days{ 2023y / January / 2 } + 16h + 4min + 5s);
+
+    // one month, clamped to the end of February, and one day and a minute
+    BOOST_CHECK(
+        smpp::parse_smpp_time("000101000100000R", now) ==
+        sys_days{ 2023y / March / 1 } + 10h + 31min);
+
+    BOOST_CHECK(!smpp::parse_smpp_time("", now));
+    BOOST_CHECK(!smpp::parse_smpp_time("230230140405600+", now));
+    BOOST_CHECK(!smpp::parse_smpp_time("230102240405600+", now));
+    BOOST_CHECK(!smpp::parse_smpp_time("230102140405649+", now));
+    BOOST_CHECK(!smpp::parse_smpp_time("2301021404056x0+", now));
+    BOOST_CHECK(!smpp::parse_smpp_time("230102140405600*", now));
+
+    auto buf = std::array<char, smpp::smpp_time_size>{};
+    smpp::format_smpp_time(now + 7s + 900ms, buf.data());
+    BOOST_CHECK(
+        std::string_view(buf.data(), buf.size()) == "230131103007900+");
+    BOOST_CHECK(
+        smpp::parse_smpp_time({ buf.data(), buf.size() }) ==
+        now + 7s + 900ms);
+
+    smpp::format_smpp_relative_time(days{ 3 } + 2h + 5s, buf.data());
+    BOOST_CHECK(
+        std::string_view(buf.data(), buf.size()) == "000003020005000R");
+    BOOST_CHECK(
+        smpp::parse_smpp_time({ buf.data(), buf.size() }, now) ==
+        now + days{ 3 } + 2h + 5s);
+    BOOST_CHECK_THROW(
+        smpp::format_smpp_relative_time(days{ 100 }, buf.data()),
+        std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(message_scheduler)
+{
+    using namespace std::chrono;
+
+    const auto now = sys_days{ 2023y / January / 1 } + 12h + 30s;
+
+    auto released  = std::vector<int>{};
+    auto expired   = std::vector<int>{};
+    auto scheduler = smpp::message_scheduler<int>{
+        [&](int& m) { released.push_back(m); },
+        [&](int& m) { expired.push_back(m); },
+        now
+    };
+
+    scheduler.schedule(1, now + 10s, now + 20s);
+    scheduler.schedule(2, now - 5s);
+    const auto h3 = scheduler.schedule(3, now + 5s, now + 90s);
+    scheduler.schedule(4, now + 40s, now + 30s);
+    scheduler.schedule(5, now + days{ 30 }, now + days{ 300 });
+    BOOST_CHECK_EQUAL(scheduler.size(), 5);
+
+    scheduler.advance(now + 1s);
+    BOOST_CHECK(released == std::vector<int>{ 2 });
+
+    scheduler.advance(now + 10s);
+    BOOST_CHECK((released == std::vector<int>{ 2, 3, 1 }));
+    BOOST_CHECK(scheduler.cancel(h3));
+    BOOST_CHECK(!scheduler.cancel(h3));
+
+    scheduler.advance(now + 2min);
+    BOOST_CHECK((expired == std::vector<int>{ 1, 4 }));
+    BOOST_CHECK_EQUAL(scheduler.size(), 1);
+
+    scheduler.advance(now + days{ 30 } - 1s);
+    BOOST_CHECK_EQUAL(released.size(), 3);
+    scheduler.advance(now + days{ 30 });
+    BOOST_CHECK_EQUAL(released.back(), 5);
+
+    scheduler.advance(now + days{ 300 });
+    BOOST_CHECK_EQUAL(expired.back(), 5);
+    BOOST_CHECK_EQUAL(scheduler.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()